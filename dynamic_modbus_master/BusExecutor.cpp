@@ -0,0 +1,101 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "BusExecutor.h"
+#include <limits>
+
+namespace dynamic_modbus_master::coro {
+
+void BusTask::promise_type::return_void() {
+    executor->m_active--;
+}
+
+BusExecutor::BusExecutor() {
+#if CONFIG_DMM_STATIC_POOLS
+    m_readySignal = xSemaphoreCreateCountingStatic(m_ready.size(), 0, &m_readySignalBuffer);
+#else
+    m_readySignal = xSemaphoreCreateCounting(std::numeric_limits<UBaseType_t>::max(), 0);
+#endif
+}
+
+BusExecutor::~BusExecutor() {
+    vSemaphoreDelete(m_readySignal);
+}
+
+ModbusError BusExecutor::spawn(BusTask task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+#if CONFIG_DMM_STATIC_POOLS
+        if (m_active >= m_ready.size()) {
+            return ModbusError::QUEUE_FULL;
+        }
+#endif
+        m_active++;
+    }
+    std::coroutine_handle<BusTask::promise_type> handle = task.m_handle;
+    task.m_handle = nullptr;
+    handle.promise().executor = this;
+    schedule(handle);
+    return ModbusError::OK;
+}
+
+void BusExecutor::run() {
+    while (m_active > 0) {
+        runOnce();
+    }
+}
+
+bool BusExecutor::runOnce(TickType_t wait) {
+    if (xSemaphoreTake(m_readySignal, wait) != pdTRUE) {
+        return false;
+    }
+    std::coroutine_handle<> handle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+#if CONFIG_DMM_STATIC_POOLS
+        handle = m_ready[m_readyFirst];
+        m_readyFirst = (m_readyFirst + 1) % m_ready.size();
+        m_readyCount--;
+#else
+        handle = m_ready.front();
+        m_ready.pop_front();
+#endif
+    }
+    handle.resume();
+    return true;
+}
+
+void BusExecutor::schedule(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+#if CONFIG_DMM_STATIC_POOLS
+        m_ready[(m_readyFirst + m_readyCount) % m_ready.size()] = handle;
+        m_readyCount++;
+#else
+        m_ready.push_back(handle);
+#endif
+    }
+    xSemaphoreGive(m_readySignal);
+}
+
+size_t BusExecutor::active() const {
+    return m_active;
+}
+}
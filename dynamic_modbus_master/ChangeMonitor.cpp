@@ -0,0 +1,199 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ChangeMonitor.h"
+#include <algorithm>
+
+namespace dynamic_modbus_master::slave {
+
+namespace {
+
+constexpr size_t WORD_REGISTERS = sizeof(uint64_t) / sizeof(uint16_t);
+
+/**
+ * Marks every register that differs between both responses, comparing 4 registers at a time.
+ */
+void diff(const uint16_t* current, const uint16_t* previous, uint16_t size, PackedBits<MAX_READ_REGISTERS>& changed) {
+    uint16_t i = 0;
+    for (; i + WORD_REGISTERS <= size; i += WORD_REGISTERS) {
+        uint64_t a;
+        uint64_t b;
+        std::memcpy(&a, current + i, sizeof(a));
+        std::memcpy(&b, previous + i, sizeof(b));
+        if (a == b) {
+            continue;
+        }
+        for (uint16_t j = i; j < i + WORD_REGISTERS; j++) {
+            changed.set(j, current[j] != previous[j]);
+        }
+    }
+    for (; i < size; i++) {
+        changed.set(i, current[i] != previous[i]);
+    }
+}
+}
+
+ChangeMonitor::ChangeMonitor(const SlaveDevice& device, uint16_t maxGap): m_device(device), m_maxGap(maxGap) {
+}
+
+size_t ChangeMonitor::subscribeBlock(RegisterType type, uint16_t reg, uint16_t size, BlockCallback callback) {
+    if (size == 0 || size > MAX_READ_REGISTERS) {
+        return INVALID_ID;
+    }
+    return add(type, reg, size, [callback = std::move(callback), reg, size](const uint16_t* registers,
+                                                                          const uint16_t* last, bool initial,
+                                                                          ChangeStatistics& statistics) {
+        if (initial) {
+            callback(reg, {registers, size});
+            statistics.notifications++;
+            return true;
+        }
+        bool notified = false;
+        for (uint16_t i = 0; i < size;) {
+            if (registers[i] == last[i]) {
+                i++;
+                continue;
+            }
+            uint16_t end = i;
+            while (end < size && registers[end] != last[end]) {
+                end++;
+            }
+            callback(static_cast<uint16_t>(reg + i), {registers + i, static_cast<size_t>(end - i)});
+            statistics.notifications++;
+            notified = true;
+            i = end;
+        }
+        return notified;
+    });
+}
+
+ModbusError ChangeMonitor::unsubscribe(size_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto subscription = std::find_if(m_subscriptions.begin(), m_subscriptions.end(), [id](const Subscription& s) {
+        return s.id == id;
+    });
+    if (subscription == m_subscriptions.end()) {
+        return ModbusError::INVALID_ARG;
+    }
+    m_subscriptions.erase(subscription);
+    m_planned = false;
+    return ModbusError::OK;
+}
+
+ModbusError ChangeMonitor::poll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_planned) {
+        plan();
+    }
+    m_statistics.polls++;
+    
+    ModbusError result = ModbusError::OK;
+    for (Block& block : m_blocks) {
+        ModbusError error = m_device.readBlock(block.type, block.regStart, block.regSize, block.current.data());
+        if (error != ModbusError::OK) {
+            m_statistics.failures++;
+            if (result == ModbusError::OK) {
+                result = error;
+            }
+            continue;
+        }
+        evaluate(block);
+    }
+    return result;
+}
+
+ChangeStatistics ChangeMonitor::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+size_t ChangeMonitor::add(RegisterType type, uint16_t reg, uint16_t size, Notify notify) {
+    if (isBitType(type) || reg + size > UINT16_MAX + 1) {
+        return INVALID_ID;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t id = m_nextId++;
+    m_subscriptions.push_back(Subscription{id, type, reg, size, std::move(notify), std::vector<uint16_t>(size), false});
+    m_planned = false;
+    return id;
+}
+
+void ChangeMonitor::plan() {
+    std::vector<size_t> order(m_subscriptions.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const Subscription& first = m_subscriptions[a];
+        const Subscription& second = m_subscriptions[b];
+        return first.type != second.type ? first.type < second.type : first.reg < second.reg;
+    });
+    
+    m_blocks.clear();
+    for (size_t index : order) {
+        const Subscription& subscription = m_subscriptions[index];
+        uint32_t end = subscription.reg + subscription.size;
+        if (!m_blocks.empty()) {
+            Block& block = m_blocks.back();
+            uint32_t blockEnd = block.regStart + block.regSize;
+            uint32_t mergedEnd = std::max(blockEnd, end);
+            if (block.type == subscription.type && subscription.reg <= blockEnd + m_maxGap &&
+                    mergedEnd - block.regStart <= MAX_READ_REGISTERS) {
+                block.regSize = static_cast<uint16_t>(mergedEnd - block.regStart);
+                block.subscriptions.push_back(index);
+                continue;
+            }
+        }
+        m_blocks.push_back(Block{subscription.type, subscription.reg, subscription.size, {index}, {}, {}, false});
+    }
+    for (Block& block : m_blocks) {
+        block.current.assign(block.regSize, 0);
+        block.previous.assign(block.regSize, 0);
+    }
+    m_planned = true;
+}
+
+void ChangeMonitor::evaluate(Block& block) {
+    PackedBits<MAX_READ_REGISTERS> changed;
+    if (block.valid) {
+        if (std::equal(block.current.begin(), block.current.end(), block.previous.begin())) {
+            m_statistics.unchangedBlocks++;
+            return;
+        }
+        diff(block.current.data(), block.previous.data(), block.regSize, changed);
+    }
+    
+    for (size_t index : block.subscriptions) {
+        Subscription& subscription = m_subscriptions[index];
+        uint16_t offset = subscription.reg - block.regStart;
+        // Registers unchanged since the previous read cannot have moved further from the last notified value
+        if (block.valid && subscription.notified && changed.findNext(offset) >= offset + subscription.size) {
+            continue;
+        }
+        const uint16_t* registers = block.current.data() + offset;
+        if (subscription.notify(registers, subscription.last.data(), !subscription.notified, m_statistics)) {
+            std::copy(registers, registers + subscription.size, subscription.last.begin());
+            subscription.notified = true;
+        }
+    }
+    std::swap(block.current, block.previous);
+    block.valid = true;
+}
+}
@@ -0,0 +1,132 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "DeviceHealth.h"
+#include <algorithm>
+
+namespace dynamic_modbus_master::slave {
+
+DeviceHealth::DeviceHealth(uint8_t quarantineThreshold, std::chrono::milliseconds probeInterval,
+                           std::chrono::milliseconds maxProbeInterval):
+        m_quarantineThreshold(std::max<uint8_t>(quarantineThreshold, 1)), m_probeInterval(probeInterval),
+        m_maxProbeInterval(std::max(probeInterval, maxProbeInterval)), m_currentInterval(probeInterval) {
+}
+
+DeviceHealth::DeviceHealth(const DeviceHealth& other) {
+    std::lock_guard<std::mutex> lock(other.m_mutex);
+    m_quarantineThreshold = other.m_quarantineThreshold;
+    m_probeInterval = other.m_probeInterval;
+    m_maxProbeInterval = other.m_maxProbeInterval;
+    m_state = other.m_state;
+    m_timeouts = other.m_timeouts;
+    m_currentInterval = other.m_currentInterval;
+    m_nextProbe = other.m_nextProbe;
+}
+
+DeviceHealth& DeviceHealth::operator=(const DeviceHealth& other) {
+    if (this != &other) {
+        std::scoped_lock lock(m_mutex, other.m_mutex);
+        m_quarantineThreshold = other.m_quarantineThreshold;
+        m_probeInterval = other.m_probeInterval;
+        m_maxProbeInterval = other.m_maxProbeInterval;
+        m_state = other.m_state;
+        m_timeouts = other.m_timeouts;
+        m_probing = false;
+        m_currentInterval = other.m_currentInterval;
+        m_nextProbe = other.m_nextProbe;
+    }
+    return *this;
+}
+
+bool DeviceHealth::admit(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state != HealthState::QUARANTINED) {
+        return true;
+    }
+    // Only a single probe is in flight, all other requests keep failing until it is answered
+    if (m_probing || now < m_nextProbe) {
+        return false;
+    }
+    m_probing = true;
+    return true;
+}
+
+void DeviceHealth::record(ModbusError result, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    switch (result) {
+        case ModbusError::TIMEOUT:
+        case ModbusError::INVALID_RESPONSE:
+        case ModbusError::FAILURE:
+        case ModbusError::GATEWAY_TARGET_NO_RESPONSE:
+            recordUnanswered(now);
+            break;
+        default:
+            if (result == ModbusError::OK || result >= ModbusError::ILLEGAL_FUNCTION) {
+                recordResponse();
+            } else {
+                m_probing = false;
+            }
+            break;
+    }
+}
+
+void DeviceHealth::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    recordResponse();
+}
+
+HealthState DeviceHealth::state() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_state;
+}
+
+DeviceHealth::Clock::time_point DeviceHealth::nextProbe() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nextProbe;
+}
+
+void DeviceHealth::recordResponse() {
+    m_state = HealthState::HEALTHY;
+    m_timeouts = 0;
+    m_probing = false;
+    m_currentInterval = m_probeInterval;
+}
+
+void DeviceHealth::recordUnanswered(Clock::time_point now) {
+    if (m_state == HealthState::QUARANTINED) {
+        if (m_probing) {
+            m_currentInterval = std::min<Clock::duration>(m_currentInterval * 2, m_maxProbeInterval);
+            m_nextProbe = now + m_currentInterval;
+            m_probing = false;
+        }
+        return;
+    }
+    if (m_timeouts < UINT8_MAX) {
+        m_timeouts++;
+    }
+    if (m_timeouts >= m_quarantineThreshold) {
+        m_state = HealthState::QUARANTINED;
+        m_currentInterval = m_probeInterval;
+        m_nextProbe = now + m_currentInterval;
+    } else {
+        m_state = HealthState::SUSPECT;
+    }
+}
+}
@@ -19,95 +19,148 @@
 //SOFTWARE.
 
 #include "DynamicModbusMaster.h"
-#include "dmm_common.h"
-#include <esp_modbus_master.h>
-#include <esp_modbus_common.h>
+#include "SlaveDevice.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "RtuTransport.h"
+#include "SerialTransport.h"
+#endif
 
 namespace dynamic_modbus_master {
 
-DynamicModbusMaster::~DynamicModbusMaster() {
-    // Check if the ModbusMaster was ever intialised.
-    if (!m_context) {
-        return;
+DynamicModbusMaster::~DynamicModbusMaster() = default;
+
+#if !CONFIG_IDF_TARGET_LINUX
+ModbusError DynamicModbusMaster::initialise(ModbusConfig config) {
+    if (m_requestQueue) {
+        return ModbusError::INVALID_STATE;
+    }
+#if CONFIG_DMM_NATIVE_RTU
+    if (config.modbusMode == MB_RTU) {
+        auto rtu = std::make_unique<transport::RtuTransport>(config);
+        ModbusError error = rtu->initialise();
+        if (error != ModbusError::OK) {
+            return error;
+        }
+        m_context = nullptr;
+        m_transport = std::move(rtu);
+        return ModbusError::OK;
     }
-    esp_err_t error = mbc_master_delete(m_context);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occured while trying to destroy the modbus communication stack %s",
-                 esp_err_to_name(error));
+#endif
+    auto serial = std::make_unique<transport::SerialTransport>(config);
+    ModbusError error = serial->initialise();
+    if (error != ModbusError::OK) {
+        return error;
     }
+    m_context = serial->getContext();
+    m_transport = std::move(serial);
+    return ModbusError::OK;
 }
+#endif
 
-ModbusError DynamicModbusMaster::initialise(ModbusConfig config) {
-    m_config = config;   
-    mb_communication_info_t commInfo = {};
-    commInfo.ser_opts.port  = m_config.uartPort;
-    commInfo.ser_opts.mode =  m_config.modbusMode;
-    commInfo.ser_opts.baudrate = m_config.baudRate;
-    commInfo.ser_opts.parity = MB_PARITY_NONE;
-    commInfo.ser_opts.uid = 0;
-    
-    esp_err_t error = mbc_master_create_serial(&commInfo, &m_context);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occurred while trying to create the serial communication: %s",
-                 esp_err_to_name(error));
-        if (error == ESP_ERR_NOT_SUPPORTED) {
-            return ModbusError::PORT_NOT_SUPPORTED;
-        } else if (error == ESP_ERR_INVALID_STATE) {
-            return ModbusError::INVALID_STATE;
-        } else {
-            return ModbusError::FAILURE;
-        }
+ModbusError DynamicModbusMaster::initialise(std::unique_ptr<transport::ModbusTransport> transport) {
+    if (!transport) {
+        return ModbusError::INVALID_ARG;
     }
-    
-    error = uart_set_pin(m_config.uartPort, m_config.txdPin, m_config.rxdPin, m_config.rtsPin, UART_PIN_NO_CHANGE);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occurred while setting the UART pins: %s", esp_err_to_name(error));
-        return ModbusError::FAILURE;
+    // The bus task might be sending a request through the current transport
+    if (m_requestQueue) {
+        return ModbusError::INVALID_STATE;
     }
-    
+    m_context = nullptr;
+    m_transport = std::move(transport);
     return ModbusError::OK;
 }
 
 ModbusError DynamicModbusMaster::start() {
-    // MBC Serial Master Start method checks that the parameter descriptor size is atleast 1 even if the table is
-    // never used. Therefore atleast one dummy entry needs to be added. See
-    // https://github.com/espressif/esp-modbus/issues/123 for more information.
-    mb_parameter_descriptor_t dummy_entry{};
-    dummy_entry.param_key = "DUMMY";
-    dummy_entry.mb_size = 1;
-
-    esp_err_t error = mbc_master_set_descriptor(m_context, &dummy_entry, 1);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occurred while registering dummy device parameter: %s", esp_err_to_name(error));
-        return ModbusError::INVALID_ARG;
+    if (!m_transport) {
+        return ModbusError::INVALID_STATE;
     }
+    return m_transport->start();
+}
 
-    error = mbc_master_start(m_context);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occurred while starting the Modbus communication stack: %s", esp_err_to_name(error));
-        return ModbusError::INVALID_ARG;
+ModbusError DynamicModbusMaster::stop() {
+    if (!m_transport) {
+        return ModbusError::INVALID_STATE;
     }
-    
-    error = uart_set_mode(m_config.uartPort, UART_MODE_RS485_HALF_DUPLEX);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occured while setting the UART mode %s", esp_err_to_name(error));
+    return m_transport->stop();
+}
+
+void* DynamicModbusMaster::getContext() const {
+    return m_context;
+}
+
+transport::ModbusTransport* DynamicModbusMaster::getTransport() const {
+    return m_transport.get();
+}
+
+ModbusError DynamicModbusMaster::startRequestQueue(size_t length, UBaseType_t priority, uint32_t stackSize,
+                                                   BaseType_t core) {
+    if (!m_transport || m_requestQueue) {
+        return ModbusError::INVALID_STATE;
+    }
+#if CONFIG_DMM_STATIC_POOLS
+    if (length > CONFIG_DMM_REQUEST_QUEUE_LENGTH) {
         return ModbusError::INVALID_ARG;
     }
-    
+    m_requestQueue.emplace(length);
+    ModbusError error = m_requestQueue->start(priority, stackSize, core);
+    if (error != ModbusError::OK) {
+        m_requestQueue.reset();
+        return error;
+    }
+#else
+    auto requestQueue = std::make_unique<RequestQueue>(length);
+    ModbusError error = requestQueue->start(priority, stackSize, core);
+    if (error != ModbusError::OK) {
+        return error;
+    }
+    m_requestQueue = std::move(requestQueue);
+#endif
     return ModbusError::OK;
 }
 
-ModbusError DynamicModbusMaster::stop() {
-    esp_err_t error = mbc_master_stop(m_context);
-    if (error != ESP_OK) {
-        ESP_LOGE(TAG, "An error occured while trying to stop the modbus communication stack %s",
-                 esp_err_to_name(error));
+ModbusError DynamicModbusMaster::stopRequestQueue() {
+    if (!m_requestQueue) {
         return ModbusError::INVALID_STATE;
     }
-    return ModbusError::OK;
+    ModbusError error = m_requestQueue->stop();
+    m_requestQueue.reset();
+    return error;
 }
 
-void* DynamicModbusMaster::getContext() const {
-    return m_context;
+RequestQueue* DynamicModbusMaster::getRequestQueue() const {
+#if CONFIG_DMM_STATIC_POOLS
+    return m_requestQueue ? &*m_requestQueue : nullptr;
+#else
+    return m_requestQueue.get();
+#endif
+}
+
+RequestMetrics& DynamicModbusMaster::getMetrics() const {
+    return m_metrics;
+}
+
+void DynamicModbusMaster::setErrorHandler(ErrorHandler handler) {
+    m_errorHandler = std::move(handler);
+}
+
+void DynamicModbusMaster::reportError(const RequestError& error) const {
+    if (m_errorHandler) {
+        m_errorHandler(error);
+    }
+}
+
+MemoryFootprint DynamicModbusMaster::getMemoryFootprint() const {
+    MemoryFootprint footprint{sizeof(DynamicModbusMaster), 0, 0, sizeof(slave::SlaveDevice)};
+#if CONFIG_DMM_STATIC_POOLS
+    footprint.master -= sizeof(m_requestQueue);
+    footprint.requestQueue = sizeof(m_requestQueue);
+#else
+    footprint.requestQueue = (m_requestQueue ? m_requestQueue->memoryFootprint() : 0);
+#endif
+    if (m_transport) {
+        footprint.transport = m_transport->memoryFootprint();
+    }
+    return footprint;
 }
 }
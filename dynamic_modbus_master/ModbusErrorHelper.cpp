@@ -19,7 +19,37 @@
 //SOFTWARE.
 
 #include "ModbusErrorHelper.h"
+#include "dmm_common.h"
+#include <esp_log.h>
+#include <cinttypes>
+#include <cstdio>
 
 namespace dynamic_modbus_master {
 
-} // dynamic_modbus_master
\ No newline at end of file
+namespace {
+
+constexpr size_t LOG_LINE_SIZE = 128;
+}
+
+size_t ModbusErrorHelper::format(const RequestError& error, char* buffer, size_t size) {
+    int length;
+    if (error.exceptionCode != 0) {
+        length = std::snprintf(buffer, size,
+                               "slave %u fc 0x%02X reg %u+%u: %s (exception 0x%02X), %u attempts in %" PRIu32 " us",
+                               error.slaveAddress, error.functionCode, error.regStart, error.regSize,
+                               modbusErrorToName(error.error).data(), error.exceptionCode, error.attempts,
+                               error.elapsedUs);
+    } else {
+        length = std::snprintf(buffer, size, "slave %u fc 0x%02X reg %u+%u: %s, %u attempts in %" PRIu32 " us",
+                               error.slaveAddress, error.functionCode, error.regStart, error.regSize,
+                               modbusErrorToName(error.error).data(), error.attempts, error.elapsedUs);
+    }
+    return length < 0 ? 0 : static_cast<size_t>(length);
+}
+
+void ModbusErrorHelper::logRequestError(const RequestError& error) {
+    char line[LOG_LINE_SIZE];
+    format(error, line, sizeof(line));
+    ESP_LOGW(TAG, "%s", line);
+}
+} // dynamic_modbus_master
@@ -0,0 +1,194 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ModbusPdu.h"
+#include <cstring>
+
+namespace dynamic_modbus_master::transport {
+
+namespace {
+
+constexpr uint8_t EXCEPTION_FLAG = 0x80;
+
+void putUint16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = static_cast<uint8_t>(value >> 8);
+    buffer[1] = static_cast<uint8_t>(value);
+}
+
+uint16_t getUint16(const uint8_t* buffer) {
+    return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+}
+
+ModbusError exceptionToError(uint8_t exceptionCode) {
+    switch (exceptionCode) {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+        case 0x05:
+        case 0x06:
+        case 0x08:
+        case 0x0A:
+        case 0x0B:
+            // The general exception codes are mapped to ModbusError with an offset of 10
+            return static_cast<ModbusError>(exceptionCode + 10);
+        default:
+            return ModbusError::INVALID_RESPONSE;
+    }
+}
+}
+
+size_t encodeRequestPdu(const ModbusRequest& request, const void* data, uint8_t* pdu) {
+    pdu[0] = request.functionCode;
+    putUint16(pdu + 1, request.regStart);
+    switch (request.functionCode) {
+        case 0x01:
+        case 0x02:
+            if (request.regSize > MAX_READ_BITS) {
+                return 0;
+            }
+            putUint16(pdu + 3, request.regSize);
+            return 5;
+        case 0x03:
+        case 0x04:
+            if (request.regSize > MAX_READ_REGISTERS) {
+                return 0;
+            }
+            putUint16(pdu + 3, request.regSize);
+            return 5;
+        case 0x05:
+        case 0x06:
+            putUint16(pdu + 3, *static_cast<const uint16_t*>(data));
+            return 5;
+        case 0x0F: {
+            if (request.regSize > MAX_WRITE_BITS) {
+                return 0;
+            }
+            uint8_t byteCount = static_cast<uint8_t>((request.regSize + 7) / 8);
+            putUint16(pdu + 3, request.regSize);
+            pdu[5] = byteCount;
+            std::memcpy(pdu + 6, data, byteCount);
+            return 6 + byteCount;
+        }
+        case 0x10: {
+            if (request.regSize > MAX_WRITE_REGISTERS) {
+                return 0;
+            }
+            const auto* registers = static_cast<const uint16_t*>(data);
+            putUint16(pdu + 3, request.regSize);
+            pdu[5] = static_cast<uint8_t>(request.regSize * 2);
+            for (uint16_t i = 0; i < request.regSize; i++) {
+                putUint16(pdu + 6 + i * 2, registers[i]);
+            }
+            return 6 + request.regSize * 2;
+        }
+        case 0x17: {
+            if (request.regSize > MAX_READ_REGISTERS || request.writeSize > MAX_READ_WRITE_REGISTERS) {
+                return 0;
+            }
+            const auto* registers = static_cast<const uint16_t*>(data);
+            putUint16(pdu + 3, request.regSize);
+            putUint16(pdu + 5, request.writeStart);
+            putUint16(pdu + 7, request.writeSize);
+            pdu[9] = static_cast<uint8_t>(request.writeSize * 2);
+            for (uint16_t i = 0; i < request.writeSize; i++) {
+                putUint16(pdu + 10 + i * 2, registers[i]);
+            }
+            return 10 + request.writeSize * 2;
+        }
+        default:
+            return 0;
+    }
+}
+
+size_t requestPduSize(const ModbusRequest& request) {
+    switch (request.functionCode) {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+        case 0x05:
+        case 0x06:
+            return 5;
+        case 0x0F:
+            return 6 + (request.regSize + 7) / 8;
+        case 0x10:
+            return 6 + request.regSize * 2;
+        case 0x17:
+            return 10 + request.writeSize * 2;
+        default:
+            return 0;
+    }
+}
+
+size_t responsePduSize(const ModbusRequest& request) {
+    switch (request.functionCode) {
+        case 0x01:
+        case 0x02:
+            return 2 + (request.regSize + 7) / 8;
+        case 0x03:
+        case 0x04:
+        case 0x17:
+            return 2 + request.regSize * 2;
+        default:
+            // Echo of address and quantity or value
+            return 5;
+    }
+}
+
+ModbusError decodeResponsePdu(const ModbusRequest& request, const uint8_t* pdu, size_t size, void* data) {
+    if (size >= 2 && pdu[0] == (request.functionCode | EXCEPTION_FLAG)) {
+        return exceptionToError(pdu[1]);
+    }
+    if (size < 2 || pdu[0] != request.functionCode) {
+        return ModbusError::INVALID_RESPONSE;
+    }
+    switch (request.functionCode) {
+        case 0x01:
+        case 0x02: {
+            size_t byteCount = (request.regSize + 7) / 8;
+            if (pdu[1] != byteCount || size != 2 + byteCount) {
+                return ModbusError::INVALID_RESPONSE;
+            }
+            std::memcpy(data, pdu + 2, byteCount);
+            return ModbusError::OK;
+        }
+        case 0x03:
+        case 0x04:
+        case 0x17: {
+            if (pdu[1] != request.regSize * 2 || size != 2 + request.regSize * 2u) {
+                return ModbusError::INVALID_RESPONSE;
+            }
+            // Function 0x17 places the read registers behind the written ones
+            auto* registers = static_cast<uint16_t*>(data) + (request.functionCode == 0x17 ? request.writeSize : 0);
+            for (uint16_t i = 0; i < request.regSize; i++) {
+                registers[i] = getUint16(pdu + 2 + i * 2);
+            }
+            return ModbusError::OK;
+        }
+        default:
+            // Writing requests are answered with an echo of address and quantity or value
+            if (size != 5 || getUint16(pdu + 1) != request.regStart) {
+                return ModbusError::INVALID_RESPONSE;
+            }
+            return ModbusError::OK;
+    }
+}
+}
@@ -0,0 +1,163 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "MultiBusMaster.h"
+#include <algorithm>
+
+namespace dynamic_modbus_master {
+
+MultiBusMaster::~MultiBusMaster() {
+    if (m_running) {
+        stop();
+    }
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+ModbusError MultiBusMaster::addBus(ModbusConfig config, BaseType_t core) {
+    if (m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    auto bus = std::make_unique<Bus>(core);
+    ModbusError error = bus->master.initialise(config);
+    if (error == ModbusError::OK) {
+        m_buses.push_back(std::move(bus));
+    }
+    return error;
+}
+#endif
+
+ModbusError MultiBusMaster::addBus(std::unique_ptr<transport::ModbusTransport> transport, BaseType_t core) {
+    if (m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    auto bus = std::make_unique<Bus>(core);
+    ModbusError error = bus->master.initialise(std::move(transport));
+    if (error == ModbusError::OK) {
+        m_buses.push_back(std::move(bus));
+    }
+    return error;
+}
+
+size_t MultiBusMaster::getBusCount() const {
+    return m_buses.size();
+}
+
+DynamicModbusMaster* MultiBusMaster::getMaster(size_t bus) const {
+    if (bus >= m_buses.size()) {
+        return nullptr;
+    }
+    return &m_buses[bus]->master;
+}
+
+ScanScheduler* MultiBusMaster::getScheduler(size_t bus) const {
+    if (bus >= m_buses.size()) {
+        return nullptr;
+    }
+    return &m_buses[bus]->scheduler;
+}
+
+ScanJobId MultiBusMaster::addJob(size_t bus, std::chrono::milliseconds period, ScanJob job) {
+    if (bus >= m_buses.size()) {
+        return ScanJobId{bus, ScanScheduler::INVALID_ID};
+    }
+    return ScanJobId{bus, m_buses[bus]->scheduler.addJob(period, std::move(job))};
+}
+
+ModbusError MultiBusMaster::removeJob(ScanJobId id) {
+    if (id.bus >= m_buses.size()) {
+        return ModbusError::INVALID_ARG;
+    }
+    return m_buses[id.bus]->scheduler.removeJob(id.id);
+}
+
+ScanStatistics MultiBusMaster::getStatistics(ScanJobId id) const {
+    if (id.bus >= m_buses.size()) {
+        return ScanStatistics{0, 0, 0, ModbusError::OK, 0};
+    }
+    return m_buses[id.bus]->scheduler.getStatistics(id.id);
+}
+
+ScanStatistics MultiBusMaster::getBusStatistics(size_t bus) const {
+    if (bus >= m_buses.size()) {
+        return ScanStatistics{0, 0, 0, ModbusError::OK, 0};
+    }
+    return m_buses[bus]->scheduler.getStatistics();
+}
+
+ScanStatistics MultiBusMaster::getStatistics() const {
+    ScanStatistics total{0, 0, 0, ModbusError::OK, 0};
+    for (const auto& bus : m_buses) {
+        ScanStatistics statistics = bus->scheduler.getStatistics();
+        total.executions += statistics.executions;
+        total.overruns += statistics.overruns;
+        total.failures += statistics.failures;
+        total.maxLatenessUs = std::max(total.maxLatenessUs, statistics.maxLatenessUs);
+        if (statistics.lastError != ModbusError::OK) {
+            total.lastError = statistics.lastError;
+        }
+    }
+    return total;
+}
+
+ModbusError MultiBusMaster::start(UBaseType_t priority, uint32_t stackSize) {
+    if (m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = true;
+    for (const auto& bus : m_buses) {
+        ModbusError error = bus->master.start();
+        if (error == ModbusError::OK) {
+            bus->started = true;
+            error = bus->master.startRequestQueue(CONFIG_DMM_REQUEST_QUEUE_LENGTH, priority, stackSize, bus->core);
+        }
+        if (error == ModbusError::OK) {
+            error = bus->scheduler.start(priority, stackSize, bus->core);
+        }
+        if (error != ModbusError::OK) {
+            stopBuses();
+            m_running = false;
+            return error;
+        }
+    }
+    return ModbusError::OK;
+}
+
+ModbusError MultiBusMaster::stop() {
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    stopBuses();
+    m_running = false;
+    return ModbusError::OK;
+}
+
+void MultiBusMaster::stopBuses() {
+    // Schedulers and request queues that were not started report INVALID_STATE, which is of no interest here.
+    // Transports are only stopped if they were started, not every transport tolerates being stopped twice.
+    for (const auto& bus : m_buses) {
+        bus->scheduler.stop();
+        bus->master.stopRequestQueue();
+        if (bus->started) {
+            bus->master.stop();
+            bus->started = false;
+        }
+    }
+}
+}
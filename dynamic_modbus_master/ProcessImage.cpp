@@ -0,0 +1,247 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ProcessImage.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <algorithm>
+#include <cstring>
+
+namespace dynamic_modbus_master {
+
+namespace {
+
+/**
+ * Number of consecutive retries after which a reader delays itself, so an interrupted update can complete.
+ */
+constexpr uint32_t RETRIES_BEFORE_DELAY = 16;
+}
+
+ProcessImage::ProcessImage(uint16_t maxGap): m_maxGap(maxGap) {
+}
+
+ModbusError ProcessImage::update() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (!m_fixed.load(std::memory_order_relaxed)) {
+        layout();
+    }
+    ModbusError result = ModbusError::OK;
+    for (size_t i = 0; i < m_blockCount; i++) {
+        ModbusError error = update(m_blocks[i]);
+        if (result == ModbusError::OK) {
+            result = error;
+        }
+    }
+    return result;
+}
+
+ModbusError ProcessImage::update(const slave::SlaveDevice& device) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (!m_fixed.load(std::memory_order_relaxed)) {
+        layout();
+    }
+    ModbusError result = ModbusError::OK;
+    for (size_t i = 0; i < m_blockCount; i++) {
+        if (m_blocks[i].device != &device) {
+            continue;
+        }
+        ModbusError error = update(m_blocks[i]);
+        if (result == ModbusError::OK) {
+            result = error;
+        }
+    }
+    return result;
+}
+
+void ProcessImage::fixLayout() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (!m_fixed.load(std::memory_order_relaxed)) {
+        layout();
+    }
+}
+
+std::vector<ImageBlock> ProcessImage::getBlocks() const {
+    std::vector<ImageBlock> blocks;
+    if (!m_fixed.load(std::memory_order_acquire)) {
+        return blocks;
+    }
+    blocks.reserve(m_blockCount);
+    for (size_t i = 0; i < m_blockCount; i++) {
+        const Block& block = m_blocks[i];
+        blocks.push_back(ImageBlock{block.device, block.type, block.regStart, block.regSize, block.offset});
+    }
+    return blocks;
+}
+
+void ProcessImage::setUpdateListener(UpdateListener listener) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    m_listener = std::move(listener);
+}
+
+size_t ProcessImage::size() const {
+    return m_fixed.load(std::memory_order_acquire) ? m_tableSize : 0;
+}
+
+ImageStatistics ProcessImage::getStatistics() const {
+    return ImageStatistics{
+        m_updates.load(std::memory_order_relaxed),
+        m_failures.load(std::memory_order_relaxed),
+        m_readRetries.load(std::memory_order_relaxed)
+    };
+}
+
+uint32_t ProcessImage::addPoint(const slave::SlaveDevice& device, RegisterType type, uint16_t reg, uint16_t size) {
+    if (isBitType(type) || reg + size > UINT16_MAX + 1) {
+        return ImagePoint<uint16_t>::INVALID_INDEX;
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_fixed.load(std::memory_order_relaxed)) {
+        return ImagePoint<uint16_t>::INVALID_INDEX;
+    }
+    m_points.push_back(Point{&device, type, reg, size, 0, 0});
+    return static_cast<uint32_t>(m_points.size() - 1);
+}
+
+ModbusError ProcessImage::readPoint(uint32_t index, uint16_t* registers, uint16_t size) const {
+    std::fill(registers, registers + size, 0);
+    if (!m_fixed.load(std::memory_order_acquire)) {
+        return (index == ImagePoint<uint16_t>::INVALID_INDEX ? ModbusError::INVALID_ARG : ModbusError::INVALID_STATE);
+    }
+    if (index >= m_points.size()) {
+        return ModbusError::INVALID_ARG;
+    }
+    const Point& point = m_points[index];
+    const Block& block = m_blocks[point.block];
+    uint16_t* table = m_table.get() + point.offset;
+    
+    for (uint32_t attempt = 0;; attempt++) {
+        uint32_t before = block.sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            for (uint16_t i = 0; i < size; i++) {
+                registers[i] = std::atomic_ref<uint16_t>(table[i]).load(std::memory_order_relaxed);
+            }
+            ModbusError error = block.error.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (block.sequence.load(std::memory_order_relaxed) == before) {
+                return error;
+            }
+        }
+        m_readRetries.fetch_add(1, std::memory_order_relaxed);
+        if (attempt % RETRIES_BEFORE_DELAY == RETRIES_BEFORE_DELAY - 1) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+ProcessImage::Clock::time_point ProcessImage::updatedAt(uint32_t index) const {
+    if (!m_fixed.load(std::memory_order_acquire) || index >= m_points.size()) {
+        return Clock::time_point::min();
+    }
+    const Block& block = m_blocks[m_points[index].block];
+    return Clock::time_point(Clock::duration(block.updated.load(std::memory_order_relaxed)));
+}
+
+void ProcessImage::layout() {
+    std::vector<size_t> order(m_points.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const Point& first = m_points[a];
+        const Point& second = m_points[b];
+        if (first.device != second.device) {
+            return std::less<const slave::SlaveDevice*>()(first.device, second.device);
+        }
+        return first.type != second.type ? first.type < second.type : first.reg < second.reg;
+    });
+    
+    // Requests are planned first, the blocks are allocated once their number is known
+    struct Range {
+        const slave::SlaveDevice* device;
+        RegisterType type;
+        uint16_t regStart;
+        uint16_t regSize;
+    };
+    std::vector<Range> ranges;
+    for (size_t index : order) {
+        Point& point = m_points[index];
+        uint32_t end = point.reg + point.size;
+        if (!ranges.empty()) {
+            Range& range = ranges.back();
+            uint32_t rangeEnd = range.regStart + range.regSize;
+            uint32_t mergedEnd = std::max(rangeEnd, end);
+            if (range.device == point.device && range.type == point.type && point.reg <= rangeEnd + m_maxGap &&
+                    mergedEnd - range.regStart <= MAX_READ_REGISTERS) {
+                range.regSize = static_cast<uint16_t>(mergedEnd - range.regStart);
+                point.block = static_cast<uint32_t>(ranges.size() - 1);
+                continue;
+            }
+        }
+        ranges.push_back(Range{point.device, point.type, point.reg, point.size});
+        point.block = static_cast<uint32_t>(ranges.size() - 1);
+    }
+    
+    m_blockCount = ranges.size();
+    m_blocks = std::make_unique<Block[]>(m_blockCount);
+    m_tableSize = 0;
+    for (size_t i = 0; i < m_blockCount; i++) {
+        Block& block = m_blocks[i];
+        block.device = ranges[i].device;
+        block.type = ranges[i].type;
+        block.regStart = ranges[i].regStart;
+        block.regSize = ranges[i].regSize;
+        block.offset = static_cast<uint32_t>(m_tableSize);
+        m_tableSize += block.regSize;
+    }
+    m_table = std::make_unique<uint16_t[]>(m_tableSize);
+    for (Point& point : m_points) {
+        const Block& block = m_blocks[point.block];
+        point.offset = block.offset + (point.reg - block.regStart);
+    }
+    m_fixed.store(true, std::memory_order_release);
+}
+
+ModbusError ProcessImage::update(Block& block) {
+    uint16_t buffer[MAX_READ_REGISTERS];
+    ModbusError error = block.device->readBlock(block.type, block.regStart, block.regSize, buffer);
+    Clock::time_point now = Clock::now();
+    
+    // Sequence lock write section, readers repeat while the sequence is odd or has changed during their read
+    uint32_t sequence = block.sequence.load(std::memory_order_relaxed);
+    block.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (error == ModbusError::OK) {
+        uint16_t* table = m_table.get() + block.offset;
+        for (uint16_t i = 0; i < block.regSize; i++) {
+            std::atomic_ref<uint16_t>(table[i]).store(buffer[i], std::memory_order_relaxed);
+        }
+        block.updated.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    // After a failure the previous values remain valid, only the error is published
+    block.error.store(error, std::memory_order_relaxed);
+    block.sequence.store(sequence + 2, std::memory_order_release);
+    
+    (error == ModbusError::OK ? m_updates : m_failures).fetch_add(1, std::memory_order_relaxed);
+    if (m_listener) {
+        m_listener(static_cast<size_t>(&block - m_blocks.get()), buffer, error, now);
+    }
+    return error;
+}
+}
@@ -0,0 +1,108 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ReadPlan.h"
+#include <algorithm>
+#include <cstring>
+
+namespace dynamic_modbus_master::slave {
+
+ReadPlan::ReadPlan(uint16_t maxGap): m_maxGap(maxGap) {
+}
+
+void ReadPlan::clear() {
+    m_points.clear();
+    m_order.clear();
+    m_blocks.clear();
+    m_planned = false;
+}
+
+const std::vector<ReadBlock>& ReadPlan::getBlocks() {
+    if (!m_planned) {
+        plan();
+    }
+    return m_blocks;
+}
+
+void ReadPlan::plan() {
+    m_order.resize(m_points.size());
+    for (size_t i = 0; i < m_order.size(); i++) {
+        m_order[i] = i;
+    }
+    std::stable_sort(m_order.begin(), m_order.end(), [this](size_t lhs, size_t rhs) {
+        const Point& left = m_points[lhs];
+        const Point& right = m_points[rhs];
+        if (left.type != right.type) {
+            return left.type < right.type;
+        }
+        return left.reg < right.reg;
+    });
+    
+    m_blocks.clear();
+    for (size_t i = 0; i < m_order.size(); i++) {
+        const Point& point = m_points[m_order[i]];
+        uint32_t pointEnd = static_cast<uint32_t>(point.reg) + point.size;
+        uint32_t limit = (isBitType(point.type) ? MAX_READ_BITS : MAX_READ_REGISTERS);
+        
+        if (!m_blocks.empty()) {
+            ReadBlock& block = m_blocks.back();
+            uint32_t blockEnd = static_cast<uint32_t>(block.regStart) + block.regSize;
+            uint32_t mergedEnd = std::max(blockEnd, pointEnd);
+            if (block.type == point.type && point.reg <= blockEnd + m_maxGap && mergedEnd - block.regStart <= limit) {
+                block.regSize = static_cast<uint16_t>(mergedEnd - block.regStart);
+                block.pointCount++;
+                continue;
+            }
+        }
+        m_blocks.push_back(ReadBlock{point.type, point.reg, point.size, i, 1});
+    }
+    m_planned = true;
+}
+
+void ReadPlan::scatter(const ReadBlock& block, const void* buffer, ModbusError error) {
+    for (size_t i = block.firstPoint; i < block.firstPoint + block.pointCount; i++) {
+        Point& point = m_points[m_order[i]];
+        *point.error = error;
+        if (error != ModbusError::OK) {
+            continue;
+        }
+        
+        uint16_t offset = point.reg - block.regStart;
+        if (!isBitType(point.type)) {
+            std::memcpy(point.data, static_cast<const uint16_t*>(buffer) + offset, point.size * sizeof(uint16_t));
+            continue;
+        }
+        
+        const auto* source = static_cast<const uint8_t*>(buffer);
+        if (point.isBool) {
+            *static_cast<bool*>(point.data) = (source[offset / 8] & (1 << (offset % 8))) != 0;
+            continue;
+        }
+        auto* target = static_cast<uint8_t*>(point.data);
+        std::memset(target, 0, (point.size + 7) / 8);
+        for (uint16_t bit = 0; bit < point.size; bit++) {
+            uint16_t sourceBit = offset + bit;
+            if (source[sourceBit / 8] & (1 << (sourceBit % 8))) {
+                target[bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,127 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RegisterCache.h"
+#include <algorithm>
+
+namespace dynamic_modbus_master::slave {
+
+namespace {
+
+template<typename Entry>
+auto findRegister(std::vector<Entry>& table, uint16_t reg) {
+    return std::lower_bound(table.begin(), table.end(), reg, [](const Entry& entry, uint16_t value) {
+        return entry.reg < value;
+    });
+}
+}
+
+RegisterCache::RegisterCache(std::chrono::milliseconds defaultTtl): m_defaultTtl(defaultTtl) {
+}
+
+void RegisterCache::setTtl(RegisterType type, uint16_t reg, uint16_t count, std::chrono::milliseconds ttl) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rules.push_back(TtlRule{type, reg, count, ttl});
+}
+
+bool RegisterCache::lookup(RegisterType type, uint16_t reg, uint16_t count, uint16_t* values, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry>& entries = table(type);
+    auto entry = findRegister(entries, reg);
+    
+    bool hit = count > 0 && static_cast<size_t>(entries.end() - entry) >= count;
+    for (uint16_t i = 0; hit && i < count; i++) {
+        hit = entry[i].reg == reg + i && entry[i].expiry > now;
+    }
+    if (!hit) {
+        m_statistics.misses++;
+        return false;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        values[i] = entry[i].value;
+    }
+    m_statistics.hits++;
+    return true;
+}
+
+void RegisterCache::store(RegisterType type, uint16_t reg, uint16_t count, const uint16_t* values,
+                          Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry>& entries = table(type);
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t current = reg + i;
+        Clock::duration timeToLive = ttl(type, current);
+        auto entry = findRegister(entries, current);
+        bool exists = entry != entries.end() && entry->reg == current;
+        if (timeToLive == Clock::duration::zero()) {
+            if (exists) {
+                entries.erase(entry);
+            }
+        } else if (exists) {
+            entry->value = values[i];
+            entry->expiry = now + timeToLive;
+        } else {
+            entries.insert(entry, Entry{current, values[i], now + timeToLive});
+        }
+    }
+}
+
+void RegisterCache::invalidate(RegisterType type, uint16_t reg, uint16_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry>& entries = table(type);
+    auto first = findRegister(entries, reg);
+    auto last = std::find_if(first, entries.end(), [end = reg + count](const Entry& entry) {
+        return entry.reg >= end;
+    });
+    m_statistics.invalidations += last - first;
+    entries.erase(first, last);
+}
+
+void RegisterCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::vector<Entry>& entries : m_tables) {
+        entries.clear();
+    }
+}
+
+CacheStatistics RegisterCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void RegisterCache::resetStatistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics = {};
+}
+
+std::vector<RegisterCache::Entry>& RegisterCache::table(RegisterType type) {
+    return m_tables[static_cast<uint8_t>(type) - 1];
+}
+
+RegisterCache::Clock::duration RegisterCache::ttl(RegisterType type, uint16_t reg) const {
+    // The most recently set rule covering the register applies
+    for (auto rule = m_rules.rbegin(); rule != m_rules.rend(); rule++) {
+        if (rule->type == type && reg >= rule->regStart && reg - rule->regStart < rule->regSize) {
+            return rule->ttl;
+        }
+    }
+    return m_defaultTtl;
+}
+}
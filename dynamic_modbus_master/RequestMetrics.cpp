@@ -0,0 +1,158 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RequestMetrics.h"
+#include "ModbusPdu.h"
+
+namespace dynamic_modbus_master {
+
+namespace {
+
+constexpr auto RELAXED = std::memory_order_relaxed;
+
+int functionIndex(uint8_t functionCode) {
+    for (size_t i = 0; i < METRIC_FUNCTION_CODES.size(); i++) {
+        if (METRIC_FUNCTION_CODES[i] == functionCode) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool isLocalError(ModbusError error) {
+    // Errors that are detected before the request is sent
+    return error == ModbusError::INVALID_ARG || error == ModbusError::INVALID_STATE ||
+           error == ModbusError::PORT_NOT_SUPPORTED || error == ModbusError::SLAVE_NOT_SUPPORTED;
+}
+}
+
+const FunctionMetrics* MetricsSnapshot::function(uint8_t functionCode) const {
+    int index = functionIndex(functionCode);
+    return index < 0 ? nullptr : &functions[index];
+}
+
+uint32_t MetricsSnapshot::errorCount(ModbusError error) const {
+    auto index = static_cast<size_t>(error);
+    return index < errors.size() ? errors[index] : 0;
+}
+
+RequestMetrics::RequestMetrics(const RequestMetrics& other) {
+    add(other.snapshot());
+}
+
+RequestMetrics& RequestMetrics::operator=(const RequestMetrics& other) {
+    if (this != &other) {
+        reset();
+        add(other.snapshot());
+    }
+    return *this;
+}
+
+void RequestMetrics::recordAttempt(const ModbusRequest& request, ModbusError result, std::chrono::microseconds latency) {
+    if (isLocalError(result)) {
+        return;
+    }
+    int index = functionIndex(request.functionCode);
+    if (index >= 0) {
+        m_functions[index].attempts.fetch_add(1, RELAXED);
+        m_functions[index].latency[latencyBucket(latency)].fetch_add(1, RELAXED);
+    }
+    
+    m_bytesSent.fetch_add(transport::requestPduSize(request), RELAXED);
+    if (result == ModbusError::OK) {
+        m_bytesReceived.fetch_add(transport::responsePduSize(request), RELAXED);
+    } else if (result >= ModbusError::ILLEGAL_FUNCTION) {
+        // Exception responses consist of the function code and the exception code
+        m_bytesReceived.fetch_add(2, RELAXED);
+    }
+}
+
+void RequestMetrics::recordRequest(ModbusError result, uint8_t attempts) {
+    m_requests.fetch_add(1, RELAXED);
+    if (attempts > 1) {
+        m_retries.fetch_add(attempts - 1, RELAXED);
+    }
+    auto index = static_cast<size_t>(result);
+    if (index < m_errors.size()) {
+        m_errors[index].fetch_add(1, RELAXED);
+    }
+}
+
+MetricsSnapshot RequestMetrics::snapshot() const {
+    MetricsSnapshot snapshot{};
+    for (size_t i = 0; i < m_functions.size(); i++) {
+        snapshot.functions[i].functionCode = METRIC_FUNCTION_CODES[i];
+        snapshot.functions[i].attempts = m_functions[i].attempts.load(RELAXED);
+        for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+            snapshot.functions[i].latency[bucket] = m_functions[i].latency[bucket].load(RELAXED);
+        }
+    }
+    for (size_t i = 0; i < m_errors.size(); i++) {
+        snapshot.errors[i] = m_errors[i].load(RELAXED);
+    }
+    snapshot.requests = m_requests.load(RELAXED);
+    snapshot.retries = m_retries.load(RELAXED);
+    snapshot.bytesSent = m_bytesSent.load(RELAXED);
+    snapshot.bytesReceived = m_bytesReceived.load(RELAXED);
+    return snapshot;
+}
+
+void RequestMetrics::reset() {
+    for (Histogram& histogram : m_functions) {
+        histogram.attempts.store(0, RELAXED);
+        for (auto& bucket : histogram.latency) {
+            bucket.store(0, RELAXED);
+        }
+    }
+    for (auto& error : m_errors) {
+        error.store(0, RELAXED);
+    }
+    m_requests.store(0, RELAXED);
+    m_retries.store(0, RELAXED);
+    m_bytesSent.store(0, RELAXED);
+    m_bytesReceived.store(0, RELAXED);
+}
+
+size_t RequestMetrics::latencyBucket(std::chrono::microseconds latency) {
+    size_t bucket = 0;
+    int64_t limit = FIRST_LATENCY_BUCKET_US;
+    while (bucket < LATENCY_BUCKETS - 1 && latency.count() >= limit) {
+        bucket++;
+        limit *= 2;
+    }
+    return bucket;
+}
+
+void RequestMetrics::add(const MetricsSnapshot& counts) {
+    for (size_t i = 0; i < m_functions.size(); i++) {
+        m_functions[i].attempts.fetch_add(counts.functions[i].attempts, RELAXED);
+        for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+            m_functions[i].latency[bucket].fetch_add(counts.functions[i].latency[bucket], RELAXED);
+        }
+    }
+    for (size_t i = 0; i < m_errors.size(); i++) {
+        m_errors[i].fetch_add(counts.errors[i], RELAXED);
+    }
+    m_requests.fetch_add(counts.requests, RELAXED);
+    m_retries.fetch_add(counts.retries, RELAXED);
+    m_bytesSent.fetch_add(counts.bytesSent, RELAXED);
+    m_bytesReceived.fetch_add(counts.bytesReceived, RELAXED);
+}
+}
@@ -0,0 +1,275 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RequestQueue.h"
+#include "dmm_common.h"
+#include <esp_log.h>
+#include <algorithm>
+
+namespace dynamic_modbus_master {
+
+#if CONFIG_DMM_STATIC_POOLS
+RequestQueue::RequestQueue(size_t length, std::chrono::milliseconds maxWait):
+        m_length(std::min<size_t>(length, CONFIG_DMM_REQUEST_QUEUE_LENGTH)), m_maxWait(maxWait) {
+}
+#else
+RequestQueue::RequestQueue(size_t length, std::chrono::milliseconds maxWait):
+        m_length(length), m_maxWait(maxWait), m_entries(std::make_unique<Entry[]>(REQUEST_PRIORITIES * length)) {
+}
+#endif
+
+RequestQueue::~RequestQueue() {
+    if (m_running) {
+        stop();
+    }
+    if (m_available) {
+        vSemaphoreDelete(m_available);
+    }
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+}
+
+ModbusError RequestQueue::start(UBaseType_t priority, uint32_t stackSize, BaseType_t core) {
+    if (m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+#if CONFIG_DMM_STATIC_POOLS
+    if (stackSize > m_stack.size() * sizeof(StackType_t)) {
+        return ModbusError::INVALID_ARG;
+    }
+#endif
+    if (!m_available) {
+        // One additional count is reserved for the stop request
+#if CONFIG_DMM_STATIC_POOLS
+        m_available = xSemaphoreCreateCountingStatic(REQUEST_PRIORITIES * m_length + 1, 0, &m_availableBuffer);
+        m_stopped = xSemaphoreCreateBinaryStatic(&m_stoppedBuffer);
+#else
+        m_available = xSemaphoreCreateCounting(REQUEST_PRIORITIES * m_length + 1, 0);
+        m_stopped = xSemaphoreCreateBinary();
+#endif
+        if (!m_available || !m_stopped) {
+            ESP_LOGE(TAG, "An error occurred while allocating the request queue");
+            return ModbusError::FAILURE;
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = true;
+    }
+#if CONFIG_DMM_STATIC_POOLS
+    m_task = xTaskCreateStaticPinnedToCore(task, "dmm_bus", stackSize, this, priority, m_stack.data(),
+                                           &m_taskBuffer, core);
+    bool created = m_task != nullptr;
+#else
+    bool created = xTaskCreatePinnedToCore(task, "dmm_bus", stackSize, this, priority, &m_task, core) == pdPASS;
+    m_stackSize = stackSize;
+#endif
+    if (!created) {
+        ESP_LOGE(TAG, "An error occurred while creating the bus task");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        return ModbusError::FAILURE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError RequestQueue::stop() {
+    {
+        // Cleared under the lock, so no request is queued once the bus task decided to finish
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return ModbusError::INVALID_STATE;
+        }
+        m_running = false;
+    }
+    // The bus task finishes once it is signalled without any request left
+    xSemaphoreGive(m_available);
+    xSemaphoreTake(m_stopped, portMAX_DELAY);
+    // The bus task suspends itself after the final signal and is deleted here, so its stack and TCB are no longer used
+    // by FreeRTOS once the queue is destroyed or started again
+    while (eTaskGetState(m_task) != eSuspended) {
+        vTaskDelay(1);
+    }
+    vTaskDelete(m_task);
+    m_task = nullptr;
+    discardPending();
+    return ModbusError::OK;
+}
+
+ModbusError RequestQueue::enqueue(AsyncRequest request, RequestPriority priority) {
+    return push(std::move(request), priority, nullptr);
+}
+
+ModbusError RequestQueue::execute(AsyncRequest request, RequestPriority priority) {
+    StaticSemaphore_t doneBuffer;
+    Waiter waiter{xSemaphoreCreateBinaryStatic(&doneBuffer), ModbusError::OK};
+    ModbusError error = push(std::move(request), priority, &waiter);
+    if (error == ModbusError::OK) {
+        xSemaphoreTake(waiter.done, portMAX_DELAY);
+        error = waiter.result;
+    }
+    vSemaphoreDelete(waiter.done);
+    return error;
+}
+
+size_t RequestQueue::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (size_t queued : m_count) {
+        count += queued;
+    }
+    return count;
+}
+
+size_t RequestQueue::pending(RequestPriority priority) const {
+    auto index = static_cast<size_t>(priority);
+    if (index >= REQUEST_PRIORITIES) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count[index];
+}
+
+QueueStatistics RequestQueue::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void RequestQueue::resetStatistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics = {};
+}
+
+size_t RequestQueue::memoryFootprint() const {
+#if CONFIG_DMM_STATIC_POOLS
+    return sizeof(RequestQueue);
+#else
+    return sizeof(RequestQueue) + REQUEST_PRIORITIES * m_length * sizeof(Entry) + m_stackSize;
+#endif
+}
+
+RequestQueue::Entry& RequestQueue::at(size_t priority, size_t position) {
+    return m_entries[priority * m_length + (m_first[priority] + position) % m_length];
+}
+
+ModbusError RequestQueue::push(AsyncRequest request, RequestPriority priority, Waiter* waiter) {
+    auto index = static_cast<size_t>(priority);
+    if (index >= REQUEST_PRIORITIES) {
+        return ModbusError::INVALID_ARG;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return ModbusError::INVALID_STATE;
+        }
+        if (m_count[index] >= m_length) {
+            return ModbusError::QUEUE_FULL;
+        }
+        Entry& entry = at(index, m_count[index]);
+        entry.request = std::move(request);
+        entry.queued = Clock::now();
+        entry.waiter = waiter;
+        m_count[index]++;
+    }
+    xSemaphoreGive(m_available);
+    return ModbusError::OK;
+}
+
+bool RequestQueue::next(Entry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = Clock::now();
+    size_t highest = 0;
+    while (highest < REQUEST_PRIORITIES && m_count[highest] == 0) {
+        highest++;
+    }
+    if (highest == REQUEST_PRIORITIES) {
+        return false;
+    }
+    
+    size_t chosen = highest;
+    if (highest != static_cast<size_t>(RequestPriority::CRITICAL)) {
+        // The request that is overdue the longest is executed first, regardless of its class
+        Clock::time_point oldest = now - m_maxWait;
+        for (size_t i = highest + 1; i < REQUEST_PRIORITIES; i++) {
+            if (m_count[i] != 0 && at(i, 0).queued < oldest && at(i, 0).queued < at(chosen, 0).queued) {
+                oldest = at(i, 0).queued;
+                chosen = i;
+            }
+        }
+    }
+    
+    entry = std::move(at(chosen, 0));
+    m_first[chosen] = (m_first[chosen] + 1) % m_length;
+    m_count[chosen]--;
+    
+    PriorityStatistics& statistics = m_statistics.priorities[chosen];
+    auto queueTimeUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - entry.queued).count());
+    statistics.executed++;
+    statistics.promoted += (chosen != highest);
+    statistics.totalQueueTimeUs += queueTimeUs;
+    statistics.maxQueueTimeUs = std::max<uint32_t>(statistics.maxQueueTimeUs,
+                                                   std::min<uint64_t>(queueTimeUs, UINT32_MAX));
+    return true;
+}
+
+void RequestQueue::discardPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t discarded = 0;
+    for (size_t priority = 0; priority < REQUEST_PRIORITIES; priority++) {
+        for (; m_count[priority] > 0; m_count[priority]--) {
+            Entry& entry = at(priority, 0);
+            if (entry.waiter) {
+                entry.waiter->result = ModbusError::INVALID_STATE;
+                xSemaphoreGive(entry.waiter->done);
+            }
+            entry = Entry{};
+            m_first[priority] = (m_first[priority] + 1) % m_length;
+            discarded++;
+        }
+    }
+    if (discarded > 0) {
+        ESP_LOGW(TAG, "Discarded %u requests that were queued when the bus task stopped",
+                 static_cast<unsigned>(discarded));
+    }
+}
+
+void RequestQueue::task(void* queue) {
+    auto* self = static_cast<RequestQueue*>(queue);
+    Entry entry;
+    while (xSemaphoreTake(self->m_available, portMAX_DELAY) == pdTRUE) {
+        if (!self->next(entry)) {
+            break;
+        }
+        entry.request();
+        if (entry.waiter) {
+            xSemaphoreGive(entry.waiter->done);
+        }
+        entry = Entry{};
+    }
+    xSemaphoreGive(self->m_stopped);
+    // Deleted by stop(), a task deleting itself would leave its TCB to the idle task
+    while (true) {
+        vTaskSuspend(nullptr);
+    }
+}
+}
@@ -0,0 +1,116 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RttEstimator.h"
+#include <algorithm>
+
+namespace dynamic_modbus_master::slave {
+
+namespace {
+
+constexpr uint8_t MAX_BACKOFF = 16;
+
+uint32_t nextRandom() {
+    // xorshift32, only used to decorrelate the retries of different devices
+    static std::atomic<uint32_t> state{0x9E3779B9};
+    uint32_t value = state.load(std::memory_order_relaxed);
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    state.store(value, std::memory_order_relaxed);
+    return value;
+}
+}
+
+RttEstimator::RttEstimator(std::chrono::milliseconds minTimeout, std::chrono::milliseconds maxTimeout):
+        m_minTimeoutUs(static_cast<uint32_t>(minTimeout.count() * 1000)),
+        m_maxTimeoutUs(static_cast<uint32_t>(maxTimeout.count() * 1000)) {
+}
+
+RttEstimator::RttEstimator(const RttEstimator& other):
+        m_minTimeoutUs(other.m_minTimeoutUs), m_maxTimeoutUs(other.m_maxTimeoutUs),
+        m_srttUs(other.m_srttUs.load(std::memory_order_relaxed)),
+        m_rttvarUs(other.m_rttvarUs.load(std::memory_order_relaxed)),
+        m_backoff(other.m_backoff.load(std::memory_order_relaxed)) {
+}
+
+RttEstimator& RttEstimator::operator=(const RttEstimator& other) {
+    m_minTimeoutUs = other.m_minTimeoutUs;
+    m_maxTimeoutUs = other.m_maxTimeoutUs;
+    m_srttUs.store(other.m_srttUs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_rttvarUs.store(other.m_rttvarUs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_backoff.store(other.m_backoff.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+void RttEstimator::addSample(std::chrono::microseconds rtt) {
+    // A mean of 0 marks the estimator as unmeasured, so every sample counts as at least 1us
+    auto sample = static_cast<uint32_t>(std::clamp<int64_t>(rtt.count(), 1, UINT32_MAX / 8));
+    uint32_t srtt = m_srttUs.load(std::memory_order_relaxed);
+    if (srtt == 0) {
+        m_srttUs.store(sample, std::memory_order_relaxed);
+        m_rttvarUs.store(sample / 2, std::memory_order_relaxed);
+    } else {
+        uint32_t deviation = (srtt > sample ? srtt - sample : sample - srtt);
+        uint32_t rttvar = m_rttvarUs.load(std::memory_order_relaxed);
+        m_rttvarUs.store(rttvar - rttvar / 4 + deviation / 4, std::memory_order_relaxed);
+        m_srttUs.store(std::max<uint32_t>(srtt - srtt / 8 + sample / 8, 1), std::memory_order_relaxed);
+    }
+    m_backoff.store(0, std::memory_order_relaxed);
+}
+
+void RttEstimator::addTimeout() {
+    uint8_t backoff = m_backoff.load(std::memory_order_relaxed);
+    if (backoff < MAX_BACKOFF) {
+        m_backoff.store(backoff + 1, std::memory_order_relaxed);
+    }
+}
+
+std::chrono::milliseconds RttEstimator::timeout() const {
+    uint64_t srtt = m_srttUs.load(std::memory_order_relaxed);
+    if (srtt == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    uint64_t timeoutUs = std::max<uint64_t>(srtt + 4 * static_cast<uint64_t>(m_rttvarUs.load(std::memory_order_relaxed)),
+                                            m_minTimeoutUs);
+    timeoutUs = std::min<uint64_t>(timeoutUs << m_backoff.load(std::memory_order_relaxed),
+                                   std::max(m_minTimeoutUs, m_maxTimeoutUs));
+    // Round up, a timeout shorter than the round-trip time would never succeed
+    return std::chrono::milliseconds((timeoutUs + 999) / 1000);
+}
+
+std::chrono::milliseconds RttEstimator::retryDelay(uint8_t attempt) {
+    uint32_t delay = CONFIG_DMM_RETRY_BACKOFF_MS;
+    for (uint8_t i = 1; i < attempt && delay < CONFIG_DMM_RETRY_BACKOFF_MAX_MS; i++) {
+        delay *= 2;
+    }
+    delay = std::min<uint32_t>(delay, CONFIG_DMM_RETRY_BACKOFF_MAX_MS);
+    uint32_t jitter = delay - delay / 2;
+    return std::chrono::milliseconds(delay / 2 + (jitter == 0 ? 0 : nextRandom() % (jitter + 1)));
+}
+
+std::chrono::microseconds RttEstimator::smoothedRtt() const {
+    return std::chrono::microseconds(m_srttUs.load(std::memory_order_relaxed));
+}
+
+std::chrono::microseconds RttEstimator::rttVariation() const {
+    return std::chrono::microseconds(m_rttvarUs.load(std::memory_order_relaxed));
+}
+}
@@ -0,0 +1,79 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RtuFrame.h"
+#include <array>
+
+namespace dynamic_modbus_master::transport {
+
+namespace {
+
+constexpr size_t CRC_SIZE = 2;
+
+constexpr std::array<uint16_t, 256> CRC_TABLE = [] {
+    std::array<uint16_t, 256> table{};
+    for (uint16_t byte = 0; byte < table.size(); byte++) {
+        uint16_t crc = byte;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+        table[byte] = crc;
+    }
+    return table;
+}();
+
+static_assert(CRC_TABLE[1] == 0xC0C1 && CRC_TABLE[255] == 0x4040, "CRC16 table does not match the Modbus polynomial");
+}
+
+uint16_t crc16(const uint8_t* data, size_t size) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 8) ^ CRC_TABLE[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+size_t encodeRtuRequest(const ModbusRequest& request, const void* data, uint8_t* frame) {
+    frame[0] = request.slaveAddress;
+    size_t pduSize = encodeRequestPdu(request, data, frame + 1);
+    if (pduSize == 0) {
+        return 0;
+    }
+    uint16_t crc = crc16(frame, 1 + pduSize);
+    frame[1 + pduSize] = static_cast<uint8_t>(crc);
+    frame[2 + pduSize] = static_cast<uint8_t>(crc >> 8);
+    return 1 + pduSize + CRC_SIZE;
+}
+
+size_t rtuResponseSize(const ModbusRequest& request) {
+    return 1 + responsePduSize(request) + CRC_SIZE;
+}
+
+ModbusError decodeRtuResponse(const ModbusRequest& request, const uint8_t* frame, size_t size, void* data) {
+    if (size < RTU_EXCEPTION_SIZE || frame[0] != request.slaveAddress) {
+        return ModbusError::INVALID_RESPONSE;
+    }
+    uint16_t crc = crc16(frame, size - CRC_SIZE);
+    if (frame[size - 2] != static_cast<uint8_t>(crc) || frame[size - 1] != static_cast<uint8_t>(crc >> 8)) {
+        return ModbusError::INVALID_RESPONSE;
+    }
+    return decodeResponsePdu(request, frame + 1, size - 1 - CRC_SIZE, data);
+}
+}
@@ -0,0 +1,178 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "RtuTransport.h"
+#include "dmm_common.h"
+#include <esp_log.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+#include <algorithm>
+
+namespace dynamic_modbus_master::transport {
+
+namespace {
+
+// Start, 8 data, parity and stop bit, the Modbus specification assumes 11 bits per character for its timings
+constexpr uint32_t BITS_PER_CHARACTER = 11;
+// Above 19200 baud the specification fixes the inter-frame gap to 1.75ms
+constexpr uint32_t MIN_FRAME_GAP_US = 1750;
+constexpr int RX_BUFFER_SIZE = 2 * MAX_RTU_FRAME_SIZE;
+}
+
+RtuTransport::RtuTransport(ModbusConfig config, std::chrono::milliseconds responseTimeout):
+        m_config(config),
+        m_responseTimeout(std::max<TickType_t>(pdMS_TO_TICKS(responseTimeout.count()), 1)),
+        m_frameGapUs(std::max<uint32_t>(MIN_FRAME_GAP_US, 7 * BITS_PER_CHARACTER * 1000000 / (2 * config.baudRate))) {
+}
+
+RtuTransport::~RtuTransport() {
+    if (!m_installed) {
+        return;
+    }
+    esp_err_t error = uart_driver_delete(m_config.uartPort);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occured while deleting the UART driver %s", esp_err_to_name(error));
+    }
+}
+
+ModbusError RtuTransport::initialise() {
+    if (m_config.modbusMode != MB_RTU) {
+        return ModbusError::PORT_NOT_SUPPORTED;
+    }
+    if (m_installed) {
+        return ModbusError::INVALID_STATE;
+    }
+    
+    uart_config_t uartConfig = {};
+    uartConfig.baud_rate = static_cast<int>(m_config.baudRate);
+    uartConfig.data_bits = UART_DATA_8_BITS;
+    uartConfig.parity = UART_PARITY_DISABLE;
+    uartConfig.stop_bits = UART_STOP_BITS_1;
+    uartConfig.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    uartConfig.source_clk = UART_SCLK_DEFAULT;
+    
+    // No transmit buffer, frames are written from the frame buffer directly into the hardware FIFO
+    esp_err_t error = uart_driver_install(m_config.uartPort, RX_BUFFER_SIZE, 0, 0, nullptr, 0);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while installing the UART driver: %s", esp_err_to_name(error));
+        return ModbusError::FAILURE;
+    }
+    m_installed = true;
+    
+    error = uart_param_config(m_config.uartPort, &uartConfig);
+    if (error == ESP_OK) {
+        error = uart_set_pin(m_config.uartPort, m_config.txdPin, m_config.rxdPin, m_config.rtsPin, UART_PIN_NO_CHANGE);
+    }
+    if (error == ESP_OK) {
+        error = uart_set_mode(m_config.uartPort, UART_MODE_RS485_HALF_DUPLEX);
+    }
+    if (error == ESP_OK) {
+        // Move received bytes to the driver after 3 silent characters instead of the default 10
+        error = uart_set_rx_timeout(m_config.uartPort, 3);
+    }
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while configuring the UART: %s", esp_err_to_name(error));
+        return ModbusError::FAILURE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError RtuTransport::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_installed) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = true;
+    return ModbusError::OK;
+}
+
+ModbusError RtuTransport::stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = false;
+    return ModbusError::OK;
+}
+
+ModbusError RtuTransport::sendRequest(const ModbusRequest& request, void* data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    if (!data) {
+        return ModbusError::INVALID_ARG;
+    }
+    size_t requestSize = encodeRtuRequest(request, data, m_frame.data());
+    if (requestSize == 0) {
+        return ModbusError::INVALID_ARG;
+    }
+    
+    waitForFrameGap();
+    uart_flush_input(m_config.uartPort);
+    if (uart_write_bytes(m_config.uartPort, m_frame.data(), requestSize) != static_cast<int>(requestSize) ||
+        uart_wait_tx_done(m_config.uartPort, transmissionTicks(requestSize)) != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while writing a request frame to the UART");
+        return ModbusError::FAILURE;
+    }
+    
+    if (request.slaveAddress == 0) {
+        m_lastFrameEndUs = esp_timer_get_time();
+        return ModbusError::OK;
+    }
+    
+    // Read the size of an exception first, it is the shortest response and identifies itself by its function code
+    TickType_t responseTimeout = m_responseTimeout;
+    if (request.timeoutMs != 0) {
+        responseTimeout = std::max<TickType_t>(pdMS_TO_TICKS(request.timeoutMs), 1);
+    }
+    int received = uart_read_bytes(m_config.uartPort, m_frame.data(), RTU_EXCEPTION_SIZE, responseTimeout);
+    if (received == static_cast<int>(RTU_EXCEPTION_SIZE) && !(m_frame[1] & 0x80)) {
+        // The frame buffer bounds the read even if the expected response size is off
+        size_t remaining = std::min(rtuResponseSize(request), m_frame.size()) - RTU_EXCEPTION_SIZE;
+        int rest = uart_read_bytes(m_config.uartPort, m_frame.data() + RTU_EXCEPTION_SIZE, remaining,
+                                   transmissionTicks(remaining));
+        received += std::max(rest, 0);
+    }
+    m_lastFrameEndUs = esp_timer_get_time();
+    
+    if (received <= 0) {
+        return ModbusError::TIMEOUT;
+    }
+    return decodeRtuResponse(request, m_frame.data(), received, data);
+}
+
+size_t RtuTransport::memoryFootprint() const {
+    return sizeof(RtuTransport) + (m_installed ? RX_BUFFER_SIZE : 0);
+}
+
+void RtuTransport::waitForFrameGap() const {
+    int64_t silence = esp_timer_get_time() - m_lastFrameEndUs;
+    if (silence < m_frameGapUs) {
+        esp_rom_delay_us(static_cast<uint32_t>(m_frameGapUs - silence));
+    }
+}
+
+TickType_t RtuTransport::transmissionTicks(size_t bytes) const {
+    uint32_t transmissionMs = bytes * BITS_PER_CHARACTER * 1000 / m_config.baudRate;
+    // Margin for gaps between characters and the resolution of the tick
+    return pdMS_TO_TICKS(transmissionMs + 10) + 1;
+}
+}
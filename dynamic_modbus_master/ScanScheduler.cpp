@@ -0,0 +1,215 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ScanScheduler.h"
+#include "dmm_common.h"
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <algorithm>
+
+namespace dynamic_modbus_master {
+
+ScanScheduler::ScanScheduler(const DynamicModbusMaster& master, uint8_t idleFillPercent):
+        m_master(master), m_idleFillPercent(std::min<uint8_t>(idleFillPercent, 100)) {
+}
+
+ScanScheduler::~ScanScheduler() {
+    if (m_running) {
+        stop();
+    }
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+}
+
+size_t ScanScheduler::addJob(std::chrono::milliseconds period, ScanJob job) {
+    if (period <= std::chrono::milliseconds::zero() || !job) {
+        return INVALID_ID;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t id = m_nextId++;
+    m_jobs.push_back(Job{id, period, Clock::now(), std::move(job), ScanStatistics{0, 0, 0, ModbusError::OK, 0},
+                         false, false});
+    return id;
+}
+
+ModbusError ScanScheduler::removeJob(size_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto job = std::find_if(m_jobs.begin(), m_jobs.end(), [id](const Job& entry) {
+        return entry.id == id && !entry.removed;
+    });
+    if (job == m_jobs.end()) {
+        return ModbusError::INVALID_ARG;
+    }
+    if (job->running) {
+        job->removed = true;
+    } else {
+        m_jobs.erase(job);
+    }
+    return ModbusError::OK;
+}
+
+ScanStatistics ScanScheduler::getStatistics(size_t id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Job& job : m_jobs) {
+        if (job.id == id && !job.removed) {
+            return job.statistics;
+        }
+    }
+    return ScanStatistics{0, 0, 0, ModbusError::OK, 0};
+}
+
+ScanStatistics ScanScheduler::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ScanStatistics total{0, 0, 0, ModbusError::OK, 0};
+    for (const Job& job : m_jobs) {
+        if (job.removed) {
+            continue;
+        }
+        total.executions += job.statistics.executions;
+        total.overruns += job.statistics.overruns;
+        total.failures += job.statistics.failures;
+        total.maxLatenessUs = std::max(total.maxLatenessUs, job.statistics.maxLatenessUs);
+        if (job.statistics.lastError != ModbusError::OK) {
+            total.lastError = job.statistics.lastError;
+        }
+    }
+    return total;
+}
+
+ScanScheduler::Clock::time_point ScanScheduler::earliestStart(const Job& job) const {
+    return job.release - job.period * m_idleFillPercent / 100;
+}
+
+bool ScanScheduler::poll(Clock::time_point now) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    // Earliest deadline first among released jobs, only if none is released the idle time is filled early.
+    Job* next = nullptr;
+    bool released = false;
+    for (Job& job : m_jobs) {
+        if (job.running) {
+            continue;
+        }
+        bool jobReleased = job.release <= now;
+        if (!jobReleased && (released || earliestStart(job) > now)) {
+            continue;
+        }
+        if (jobReleased && !released) {
+            next = nullptr;
+            released = true;
+        }
+        if (!next || job.release + job.period < next->release + next->period) {
+            next = &job;
+        }
+    }
+    if (!next) {
+        return false;
+    }
+    
+    Clock::time_point deadline = next->release + next->period;
+    next->running = true;
+    lock.unlock();
+    ModbusError error = next->job();
+    Clock::time_point completion = Clock::now();
+    lock.lock();
+    next->running = false;
+    if (next->removed) {
+        m_jobs.remove_if([next](const Job& job) { return &job == next; });
+        return true;
+    }
+    
+    ScanStatistics& statistics = next->statistics;
+    statistics.executions++;
+    statistics.lastError = error;
+    if (error != ModbusError::OK) {
+        statistics.failures++;
+    }
+    if (completion > deadline) {
+        auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(completion - deadline).count();
+        statistics.overruns++;
+        statistics.maxLatenessUs = std::max<uint32_t>(statistics.maxLatenessUs, lateness);
+    }
+    
+    next->release = deadline;
+    if (next->release + next->period <= completion) {
+        // Whole cycles were missed, count them and realign the job instead of executing it repeatedly to catch up.
+        auto missed = (completion - next->release) / next->period;
+        statistics.overruns += missed;
+        next->release += next->period * missed;
+    }
+    return true;
+}
+
+ScanScheduler::Clock::time_point ScanScheduler::nextStart() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point start = Clock::time_point::max();
+    for (const Job& job : m_jobs) {
+        if (!job.running) {
+            start = std::min(start, earliestStart(job));
+        }
+    }
+    return start;
+}
+
+ModbusError ScanScheduler::start(UBaseType_t priority, uint32_t stackSize, BaseType_t core) {
+    if (m_running || !m_master.getTransport()) {
+        return ModbusError::INVALID_STATE;
+    }
+    if (!m_stopped) {
+        m_stopped = xSemaphoreCreateBinary();
+        if (!m_stopped) {
+            return ModbusError::FAILURE;
+        }
+    }
+    
+    m_running = true;
+    if (xTaskCreatePinnedToCore(task, "dmm_scan", stackSize, this, priority, nullptr, core) != pdPASS) {
+        ESP_LOGE(TAG, "An error occurred while creating the scan scheduler task");
+        m_running = false;
+        return ModbusError::FAILURE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError ScanScheduler::stop() {
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = false;
+    xSemaphoreTake(m_stopped, portMAX_DELAY);
+    return ModbusError::OK;
+}
+
+void ScanScheduler::task(void* scheduler) {
+    auto* self = static_cast<ScanScheduler*>(scheduler);
+    while (self->m_running) {
+        if (self->poll()) {
+            continue;
+        }
+        // Sleep until the next job may start, but wake up regularly to pick up new jobs and stop requests.
+        auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(self->nextStart() - Clock::now()).count();
+        TickType_t ticks = pdMS_TO_TICKS(std::clamp<long long>(idle, 1, 100));
+        vTaskDelay(std::max<TickType_t>(ticks, 1));
+    }
+    xSemaphoreGive(self->m_stopped);
+    vTaskDelete(nullptr);
+}
+}
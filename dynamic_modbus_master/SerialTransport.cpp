@@ -0,0 +1,148 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "SerialTransport.h"
+#include "dmm_common.h"
+#include <esp_modbus_master.h>
+#include <esp_modbus_common.h>
+
+namespace dynamic_modbus_master::transport {
+
+SerialTransport::SerialTransport(ModbusConfig config): m_config(config) {
+}
+
+SerialTransport::~SerialTransport() {
+    // Check if the ModbusMaster was ever intialised.
+    if (!m_context) {
+        return;
+    }
+    esp_err_t error = mbc_master_delete(m_context);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occured while trying to destroy the modbus communication stack %s",
+                 esp_err_to_name(error));
+    }
+}
+
+ModbusError SerialTransport::initialise() {
+    mb_communication_info_t commInfo = {};
+    commInfo.ser_opts.port  = m_config.uartPort;
+    commInfo.ser_opts.mode =  m_config.modbusMode;
+    commInfo.ser_opts.baudrate = m_config.baudRate;
+    commInfo.ser_opts.parity = MB_PARITY_NONE;
+    commInfo.ser_opts.uid = 0;
+    
+    esp_err_t error = mbc_master_create_serial(&commInfo, &m_context);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while trying to create the serial communication: %s",
+                 esp_err_to_name(error));
+        if (error == ESP_ERR_NOT_SUPPORTED) {
+            return ModbusError::PORT_NOT_SUPPORTED;
+        } else if (error == ESP_ERR_INVALID_STATE) {
+            return ModbusError::INVALID_STATE;
+        } else {
+            return ModbusError::FAILURE;
+        }
+    }
+    
+    error = uart_set_pin(m_config.uartPort, m_config.txdPin, m_config.rxdPin, m_config.rtsPin, UART_PIN_NO_CHANGE);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while setting the UART pins: %s", esp_err_to_name(error));
+        return ModbusError::FAILURE;
+    }
+    
+    return ModbusError::OK;
+}
+
+ModbusError SerialTransport::start() {
+    // MBC Serial Master Start method checks that the parameter descriptor size is atleast 1 even if the table is
+    // never used. Therefore atleast one dummy entry needs to be added. See
+    // https://github.com/espressif/esp-modbus/issues/123 for more information.
+    mb_parameter_descriptor_t dummy_entry{};
+    dummy_entry.param_key = "DUMMY";
+    dummy_entry.mb_size = 1;
+
+    esp_err_t error = mbc_master_set_descriptor(m_context, &dummy_entry, 1);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while registering dummy device parameter: %s", esp_err_to_name(error));
+        return ModbusError::INVALID_ARG;
+    }
+
+    error = mbc_master_start(m_context);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occurred while starting the Modbus communication stack: %s", esp_err_to_name(error));
+        return ModbusError::INVALID_ARG;
+    }
+    
+    error = uart_set_mode(m_config.uartPort, UART_MODE_RS485_HALF_DUPLEX);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occured while setting the UART mode %s", esp_err_to_name(error));
+        return ModbusError::INVALID_ARG;
+    }
+    
+    return ModbusError::OK;
+}
+
+ModbusError SerialTransport::stop() {
+    esp_err_t error = mbc_master_stop(m_context);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "An error occured while trying to stop the modbus communication stack %s",
+                 esp_err_to_name(error));
+        return ModbusError::INVALID_STATE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError SerialTransport::sendRequest(const ModbusRequest& request, void* data) {
+    // The generic request of esp-modbus cannot describe the write part of Function Code 0x17
+    if (request.functionCode == 0x17) {
+        return ModbusError::SLAVE_NOT_SUPPORTED;
+    }
+    mb_param_request_t mbRequest {
+        .slave_addr = request.slaveAddress,
+        .command = request.functionCode,
+        .reg_start = request.regStart,
+        .reg_size = request.regSize
+    };
+    
+    esp_err_t error = mbc_master_send_request(m_context, &mbRequest, data);
+    switch (error) {
+        case ESP_OK:
+            return ModbusError::OK;
+        case ESP_ERR_TIMEOUT:
+            return ModbusError::TIMEOUT;
+        case ESP_ERR_INVALID_ARG:
+            return ModbusError::INVALID_ARG;
+        case ESP_ERR_NOT_SUPPORTED:
+            return ModbusError::SLAVE_NOT_SUPPORTED;
+        case ESP_ERR_INVALID_RESPONSE:
+            return ModbusError::INVALID_RESPONSE;
+        default:
+            return ModbusError::FAILURE;
+    }
+}
+
+size_t SerialTransport::memoryFootprint() const {
+    return sizeof(SerialTransport);
+}
+
+void* SerialTransport::getContext() const {
+    return m_context;
+}
+}
@@ -0,0 +1,127 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "SharedImageExporter.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace dynamic_modbus_master {
+
+SharedImageExporter::SharedImageExporter(ProcessImage& image): m_image(image) {
+}
+
+SharedImageExporter::~SharedImageExporter() {
+    close();
+}
+
+ModbusError SharedImageExporter::open(const char* name) {
+    if (m_segment != nullptr) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_image.fixLayout();
+    std::vector<ImageBlock> blocks = m_image.getBlocks();
+    size_t size = sharedImageSize(blocks.size(), m_image.size());
+    
+    // Readers that still map a previous segment keep the unlinked object instead of seeing it truncated
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return ModbusError::FAILURE;
+    }
+    void* segment = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        shm_unlink(name);
+        return ModbusError::FAILURE;
+    }
+    
+    auto* header = static_cast<SharedImageHeader*>(segment);
+    header->version = SHARED_IMAGE_VERSION;
+    header->headerSize = sizeof(SharedImageHeader);
+    header->blockCount = static_cast<uint32_t>(blocks.size());
+    header->tableSize = static_cast<uint32_t>(m_image.size());
+    header->blocksOffset = sizeof(SharedImageHeader);
+    header->tableOffset = static_cast<uint32_t>(sharedTableOffset(blocks.size()));
+    header->segmentSize = size;
+    auto* shared = reinterpret_cast<SharedBlock*>(static_cast<uint8_t*>(segment) + header->blocksOffset);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        shared[i] = SharedBlock{
+            0,
+            blocks[i].device->getAddress(),
+            static_cast<uint8_t>(blocks[i].type),
+            blocks[i].regStart,
+            blocks[i].regSize,
+            static_cast<uint16_t>(ModbusError::INVALID_STATE),
+            blocks[i].offset,
+            INT64_MIN
+        };
+    }
+    // Readers validate the magic, it is published after the rest of the segment
+    std::atomic_ref<uint32_t>(header->magic).store(SHARED_IMAGE_MAGIC, std::memory_order_release);
+    
+    m_name = name;
+    m_segment = segment;
+    m_size = size;
+    m_image.setUpdateListener([this](size_t block, const uint16_t* registers, ModbusError error,
+                                     ProcessImage::Clock::time_point updated) {
+        publish(block, registers, error, updated);
+    });
+    return ModbusError::OK;
+}
+
+void SharedImageExporter::close() {
+    if (m_segment == nullptr) {
+        return;
+    }
+    m_image.setUpdateListener({});
+    munmap(m_segment, m_size);
+    shm_unlink(m_name.c_str());
+    m_segment = nullptr;
+    m_size = 0;
+    m_name.clear();
+}
+
+void SharedImageExporter::publish(size_t block, const uint16_t* registers, ModbusError error,
+                                  ProcessImage::Clock::time_point updated) {
+    auto* header = static_cast<SharedImageHeader*>(m_segment);
+    auto* base = static_cast<uint8_t*>(m_segment);
+    SharedBlock& shared = reinterpret_cast<SharedBlock*>(base + header->blocksOffset)[block];
+    auto* table = reinterpret_cast<uint16_t*>(base + header->tableOffset) + shared.offset;
+    
+    std::atomic_ref<uint32_t> sequence(shared.sequence);
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (error == ModbusError::OK) {
+        for (uint16_t i = 0; i < shared.regSize; i++) {
+            std::atomic_ref<uint16_t>(table[i]).store(registers[i], std::memory_order_relaxed);
+        }
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(updated.time_since_epoch()).count();
+        std::atomic_ref<int64_t>(shared.updatedNs).store(nanoseconds, std::memory_order_relaxed);
+    }
+    std::atomic_ref<uint16_t>(shared.error).store(static_cast<uint16_t>(error), std::memory_order_relaxed);
+    sequence.store(current + 2, std::memory_order_release);
+}
+}
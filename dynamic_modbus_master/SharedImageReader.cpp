@@ -0,0 +1,157 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "SharedImageReader.h"
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace dynamic_modbus_master {
+
+SharedImageReader::~SharedImageReader() {
+    close();
+}
+
+ModbusError SharedImageReader::open(const char* name) {
+    if (m_segment != nullptr) {
+        return ModbusError::INVALID_STATE;
+    }
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return ModbusError::FAILURE;
+    }
+    struct stat status{};
+    void* segment = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(SharedImageHeader)) {
+        segment = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        return ModbusError::FAILURE;
+    }
+    m_segment = static_cast<const uint8_t*>(segment);
+    m_size = static_cast<size_t>(status.st_size);
+    
+    // The atomic load does not modify the read-only mapping
+    uint32_t magic = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(header().magic)).load(std::memory_order_acquire);
+    const SharedImageHeader& layout = header();
+    if (magic != SHARED_IMAGE_MAGIC || layout.version != SHARED_IMAGE_VERSION ||
+            layout.headerSize != sizeof(SharedImageHeader) || layout.blocksOffset != sizeof(SharedImageHeader) ||
+            layout.tableOffset != sharedTableOffset(layout.blockCount) ||
+            layout.segmentSize != sharedImageSize(layout.blockCount, layout.tableSize) || layout.segmentSize > m_size) {
+        close();
+        return ModbusError::INVALID_RESPONSE;
+    }
+    // The descriptors are within the mapping now, the registers of every block must be within the table
+    const SharedBlock* first = blocks();
+    const SharedBlock* last = first + layout.blockCount;
+    if (std::any_of(first, last, [&layout](const SharedBlock& block) {
+            return static_cast<uint64_t>(block.offset) + block.regSize > layout.tableSize;
+        })) {
+        close();
+        return ModbusError::INVALID_RESPONSE;
+    }
+    return ModbusError::OK;
+}
+
+void SharedImageReader::close() {
+    if (m_segment == nullptr) {
+        return;
+    }
+    munmap(const_cast<uint8_t*>(m_segment), m_size);
+    m_segment = nullptr;
+    m_size = 0;
+}
+
+size_t SharedImageReader::blockCount() const {
+    return m_segment != nullptr ? header().blockCount : 0;
+}
+
+SharedBlock SharedImageReader::block(size_t index) const {
+    auto& shared = const_cast<SharedBlock&>(blocks()[index]);
+    SharedBlock result = shared;
+    result.sequence = std::atomic_ref<uint32_t>(shared.sequence).load(std::memory_order_relaxed);
+    result.error = std::atomic_ref<uint16_t>(shared.error).load(std::memory_order_relaxed);
+    result.updatedNs = std::atomic_ref<int64_t>(shared.updatedNs).load(std::memory_order_relaxed);
+    return result;
+}
+
+ModbusError SharedImageReader::readRegisters(uint8_t slaveAddress, RegisterType type, uint16_t reg, uint16_t size,
+                                             uint16_t* registers, int64_t* updatedNs) const {
+    if (m_segment == nullptr) {
+        return ModbusError::INVALID_STATE;
+    }
+    const SharedBlock* first = blocks();
+    const SharedBlock* last = first + header().blockCount;
+    const SharedBlock* found = std::find_if(first, last, [=](const SharedBlock& block) {
+        return block.slaveAddress == slaveAddress && block.type == static_cast<uint8_t>(type) &&
+               block.regStart <= reg && reg + size <= block.regStart + block.regSize;
+    });
+    if (found == last || size == 0) {
+        return ModbusError::ADDRESS_UNAVAILABLE;
+    }
+    
+    auto& shared = const_cast<SharedBlock&>(*found);
+    auto* table = const_cast<uint16_t*>(reinterpret_cast<const uint16_t*>(m_segment + header().tableOffset)) +
+                  shared.offset + (reg - shared.regStart);
+    std::atomic_ref<uint32_t> sequence(shared.sequence);
+    std::chrono::steady_clock::time_point deadline{};
+    while (true) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            for (uint16_t i = 0; i < size; i++) {
+                registers[i] = std::atomic_ref<uint16_t>(table[i]).load(std::memory_order_relaxed);
+            }
+            auto error = static_cast<ModbusError>(std::atomic_ref<uint16_t>(shared.error).load(std::memory_order_relaxed));
+            int64_t updated = std::atomic_ref<int64_t>(shared.updatedNs).load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                if (updatedNs != nullptr) {
+                    *updatedNs = updated;
+                }
+                return error;
+            }
+        }
+        // The clock is only read once a read collided with an update, an exporter that died while updating the block
+        // must not block the reader forever
+        auto now = std::chrono::steady_clock::now();
+        if (deadline == std::chrono::steady_clock::time_point{}) {
+            deadline = now + SHARED_IMAGE_READ_TIMEOUT;
+        } else if (now >= deadline) {
+            return ModbusError::TIMEOUT;
+        }
+        // The exporter is another process, yielding lets it complete the update
+        sched_yield();
+    }
+}
+
+const SharedImageHeader& SharedImageReader::header() const {
+    return *reinterpret_cast<const SharedImageHeader*>(m_segment);
+}
+
+const SharedBlock* SharedImageReader::blocks() const {
+    return reinterpret_cast<const SharedBlock*>(m_segment + header().blocksOffset);
+}
+}
@@ -0,0 +1,275 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "SimulatedTransport.h"
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace dynamic_modbus_master::transport {
+
+namespace {
+
+constexpr size_t FRAME_OVERHEAD = 4;   // Address, function code and CRC16
+constexpr uint32_t BITS_PER_CHARACTER = 10;
+
+size_t requestFrameSize(const ModbusRequest& request) {
+    switch (request.functionCode) {
+        case 0x0F:
+            return FRAME_OVERHEAD + 5 + (request.regSize + 7) / 8;
+        case 0x10:
+            return FRAME_OVERHEAD + 5 + request.regSize * sizeof(uint16_t);
+        case 0x17:
+            return FRAME_OVERHEAD + 9 + request.writeSize * sizeof(uint16_t);
+        default:
+            return FRAME_OVERHEAD + 4;
+    }
+}
+
+size_t responseFrameSize(const ModbusRequest& request, ModbusError result) {
+    if (result == ModbusError::TIMEOUT) {
+        return 0;
+    }
+    if (result != ModbusError::OK) {
+        return FRAME_OVERHEAD + 1;
+    }
+    switch (request.functionCode) {
+        case 0x01:
+        case 0x02:
+            return FRAME_OVERHEAD + 1 + (request.regSize + 7) / 8;
+        case 0x03:
+        case 0x04:
+        case 0x17:
+            return FRAME_OVERHEAD + 1 + request.regSize * sizeof(uint16_t);
+        default:
+            return FRAME_OVERHEAD + 4;
+    }
+}
+
+bool exceedsTable(size_t tableSize, const ModbusRequest& request) {
+    return static_cast<size_t>(request.regStart) + request.regSize > tableSize;
+}
+
+ModbusError readRegisters(const std::vector<uint16_t>& table, const ModbusRequest& request, void* data) {
+    if (request.regSize == 0 || request.regSize > MAX_READ_REGISTERS) {
+        return ModbusError::ILLEGAL_DATA_VALUE;
+    }
+    if (exceedsTable(table.size(), request)) {
+        return ModbusError::ILLEGAL_DATA_ADDRESS;
+    }
+    std::memcpy(data, table.data() + request.regStart, request.regSize * sizeof(uint16_t));
+    return ModbusError::OK;
+}
+
+ModbusError writeRegisters(std::vector<uint16_t>& table, const ModbusRequest& request, const void* data) {
+    if (request.regSize == 0 || request.regSize > MAX_WRITE_REGISTERS) {
+        return ModbusError::ILLEGAL_DATA_VALUE;
+    }
+    if (exceedsTable(table.size(), request)) {
+        return ModbusError::ILLEGAL_DATA_ADDRESS;
+    }
+    std::memcpy(table.data() + request.regStart, data, request.regSize * sizeof(uint16_t));
+    return ModbusError::OK;
+}
+
+ModbusError readBits(const std::vector<bool>& table, const ModbusRequest& request, void* data) {
+    if (request.regSize == 0 || request.regSize > MAX_READ_BITS) {
+        return ModbusError::ILLEGAL_DATA_VALUE;
+    }
+    if (exceedsTable(table.size(), request)) {
+        return ModbusError::ILLEGAL_DATA_ADDRESS;
+    }
+    auto* bytes = static_cast<uint8_t*>(data);
+    std::memset(bytes, 0, (request.regSize + 7) / 8);
+    for (uint16_t i = 0; i < request.regSize; i++) {
+        if (table[request.regStart + i]) {
+            bytes[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+        }
+    }
+    return ModbusError::OK;
+}
+
+ModbusError writeBits(std::vector<bool>& table, const ModbusRequest& request, const void* data) {
+    if (request.regSize == 0 || request.regSize > MAX_WRITE_BITS) {
+        return ModbusError::ILLEGAL_DATA_VALUE;
+    }
+    if (exceedsTable(table.size(), request)) {
+        return ModbusError::ILLEGAL_DATA_ADDRESS;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (uint16_t i = 0; i < request.regSize; i++) {
+        table[request.regStart + i] = (bytes[i / 8] & (1 << (i % 8))) != 0;
+    }
+    return ModbusError::OK;
+}
+}
+
+SimulatedSlave& SimulatedTransport::addSlave(uint8_t address, uint16_t tableSize) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SimulatedSlave& slave = m_slaves[address];
+    slave.holdingRegisters.assign(tableSize, 0);
+    slave.inputRegisters.assign(tableSize, 0);
+    slave.coils.assign(tableSize, false);
+    slave.discreteInputs.assign(tableSize, false);
+    return slave;
+}
+
+SimulatedSlave* SimulatedTransport::getSlave(uint8_t address) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto slave = m_slaves.find(address);
+    if (slave == m_slaves.end()) {
+        return nullptr;
+    }
+    return &slave->second;
+}
+
+void SimulatedTransport::setBaudRate(uint32_t baudRate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_baudRate = baudRate;
+}
+
+WireStatistics SimulatedTransport::getWireStatistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void SimulatedTransport::resetWireStatistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics = {};
+}
+
+void SimulatedTransport::accountTraffic(const ModbusRequest& request, ModbusError result) {
+    size_t sent = requestFrameSize(request);
+    size_t received = responseFrameSize(request, result);
+    m_statistics.requests++;
+    m_statistics.bytesSent += sent;
+    m_statistics.bytesReceived += received;
+    
+    if (m_baudRate == 0) {
+        return;
+    }
+    // Each frame is followed by a silent interval of 3.5 characters, 7 characters in total for request and response.
+    uint64_t busTimeUs = (sent + received + 7) * BITS_PER_CHARACTER * 1000000 / m_baudRate;
+    m_statistics.busTimeUs += busTimeUs;
+    std::this_thread::sleep_for(std::chrono::microseconds(busTimeUs));
+}
+
+ModbusError SimulatedTransport::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = true;
+    return ModbusError::OK;
+}
+
+ModbusError SimulatedTransport::stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = false;
+    return ModbusError::OK;
+}
+
+ModbusError SimulatedTransport::sendRequest(const ModbusRequest& request, void* data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    if (!data) {
+        return ModbusError::INVALID_ARG;
+    }
+    auto slave = m_slaves.find(request.slaveAddress);
+    ModbusError result = ModbusError::TIMEOUT;
+    if (slave != m_slaves.end()) {
+        std::chrono::microseconds delay = slave->second.responseDelay;
+        std::chrono::microseconds timeout = std::chrono::milliseconds(request.timeoutMs);
+        if (request.timeoutMs != 0 && delay > timeout) {
+            std::this_thread::sleep_for(timeout);
+        } else {
+            std::this_thread::sleep_for(delay);
+            result = handleRequest(slave->second, request, data);
+        }
+    }
+    accountTraffic(request, result);
+    return result;
+}
+
+size_t SimulatedTransport::memoryFootprint() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t size = sizeof(SimulatedTransport);
+    for (const auto& [address, slave] : m_slaves) {
+        size += sizeof(slave) + (slave.holdingRegisters.capacity() + slave.inputRegisters.capacity()) * sizeof(uint16_t) +
+                (slave.coils.capacity() + slave.discreteInputs.capacity()) / 8;
+    }
+    return size;
+}
+
+ModbusError SimulatedTransport::handleRequest(SimulatedSlave& slave, const ModbusRequest& request, void* data) {
+    switch (request.functionCode) {
+        case 0x01:
+            return readBits(slave.coils, request, data);
+        case 0x02:
+            return readBits(slave.discreteInputs, request, data);
+        case 0x03:
+            return readRegisters(slave.holdingRegisters, request, data);
+        case 0x04:
+            return readRegisters(slave.inputRegisters, request, data);
+        case 0x05: {
+            uint16_t value = *static_cast<const uint16_t*>(data);
+            if (value != 0xFF00 && value != 0x0000) {
+                return ModbusError::ILLEGAL_DATA_VALUE;
+            }
+            if (request.regStart >= slave.coils.size()) {
+                return ModbusError::ILLEGAL_DATA_ADDRESS;
+            }
+            slave.coils[request.regStart] = (value == 0xFF00);
+            return ModbusError::OK;
+        }
+        case 0x06: {
+            ModbusRequest single = request;
+            single.regSize = 1;
+            return writeRegisters(slave.holdingRegisters, single, data);
+        }
+        case 0x0F:
+            return writeBits(slave.coils, request, data);
+        case 0x10:
+            return writeRegisters(slave.holdingRegisters, request, data);
+        case 0x17: {
+            ModbusRequest write = request;
+            write.regStart = request.writeStart;
+            write.regSize = request.writeSize;
+            if (request.writeSize > MAX_READ_WRITE_REGISTERS || request.regSize == 0 ||
+                request.regSize > MAX_READ_REGISTERS) {
+                return ModbusError::ILLEGAL_DATA_VALUE;
+            }
+            if (exceedsTable(slave.holdingRegisters.size(), request)) {
+                return ModbusError::ILLEGAL_DATA_ADDRESS;
+            }
+            // The write is performed before the read
+            ModbusError error = writeRegisters(slave.holdingRegisters, write, data);
+            if (error != ModbusError::OK) {
+                return error;
+            }
+            return readRegisters(slave.holdingRegisters, request, static_cast<uint16_t*>(data) + request.writeSize);
+        }
+        default:
+            return ModbusError::ILLEGAL_FUNCTION;
+    }
+}
+}
@@ -19,38 +19,255 @@
 //SOFTWARE.
 
 #include "SlaveDevice.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <chrono>
 
 namespace dynamic_modbus_master::slave {
 
-ModbusError SlaveDevice::sendRequest(mb_param_request_t request, void *data) const{
+namespace {
+
+size_t splitSize(size_t maxRegisters, size_t elementSize) {
+    return elementSize <= maxRegisters ? maxRegisters / elementSize * elementSize : maxRegisters;
+}
+
+bool isResponse(ModbusError error) {
+    // Exceptions are responses of the device as well, their round-trip time is just as representative
+    return error == ModbusError::OK ||
+           (error >= ModbusError::ILLEGAL_FUNCTION && error != ModbusError::GATEWAY_TARGET_NO_RESPONSE);
+}
+}
+
+ModbusError SlaveDevice::sendRequest(const ModbusRequest& request, void *data, bool probe) const{
+    auto requestStart = std::chrono::steady_clock::now();
+    transport::ModbusTransport* transport = m_master.getTransport();
+    if (!transport) {
+        recordRequest(request, ModbusError::INVALID_STATE, 0, requestStart);
+        return ModbusError::INVALID_STATE;
+    }
+    
+    // Broadcasts are never answered, they do not tell anything about the health of a device
+    bool broadcast = (m_address == 0);
+    if (!broadcast && !m_health.admit()) {
+        recordRequest(request, ModbusError::DEVICE_QUARANTINED, 0, requestStart);
+        return ModbusError::DEVICE_QUARANTINED;
+    }
+    // Suspect devices and probes of quarantined devices get a single attempt, so they occupy the bus only briefly
+    uint8_t retries = (m_health.state() == HealthState::HEALTHY ? m_retries : 0);
+    
+    ModbusRequest attempt = request;
     uint8_t attempts = 0;
-    esp_err_t error;
+    ModbusError error;
     do {
+        if (attempts > 0) {
+            TickType_t delay = pdMS_TO_TICKS(RttEstimator::retryDelay(attempts).count());
+            if (delay > 0) {
+                vTaskDelay(delay);
+            }
+        }
         attempts++;
-        error = mbc_master_send_request(m_master.getContext(), &request, data);
-        if (error != ESP_ERR_TIMEOUT) {
+        if (request.timeoutMs == 0) {
+            attempt.timeoutMs = static_cast<uint32_t>(m_rtt.timeout().count());
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        error = transport->sendRequest(attempt, data);
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        m_metrics.recordAttempt(attempt, error, latency);
+        m_master.getMetrics().recordAttempt(attempt, error, latency);
+        if (error != ModbusError::TIMEOUT) {
+            // Only the first attempt is measured, a late response could otherwise be mistaken for that of a retry
+            if (attempts == 1 && !broadcast && isResponse(error)) {
+                m_rtt.addSample(latency);
+            }
             break;
         }
-    } while(attempts <= m_retries);
-    if ((attempts > m_retries && m_retries > 0) || error == ESP_ERR_TIMEOUT) {
-        return ModbusError::TIMEOUT;
-    } else {
-        switch (error) {
-            case ESP_OK:
-                return ModbusError::OK;
-            case ESP_ERR_INVALID_ARG:
-                return ModbusError::INVALID_ARG;
-            case ESP_ERR_NOT_SUPPORTED:
-                return ModbusError::SLAVE_NOT_SUPPORTED;
-            case ESP_ERR_INVALID_RESPONSE:
-                return ModbusError::INVALID_RESPONSE;
-            default:
-                return ModbusError::FAILURE;
+        m_rtt.addTimeout();
+    } while(attempts <= retries);
+    if (!broadcast) {
+        m_health.record(error);
+    }
+    if (probe && (error == ModbusError::ILLEGAL_FUNCTION || error == ModbusError::SLAVE_NOT_SUPPORTED)) {
+        // The caller falls back to other function codes, which are recorded instead
+        return error;
+    }
+    recordRequest(request, error, attempts, requestStart);
+    return error;
+}
+
+void SlaveDevice::recordRequest(const ModbusRequest& request, ModbusError error, uint8_t attempts,
+                                std::chrono::steady_clock::time_point start) const {
+    m_metrics.recordRequest(error, attempts);
+    m_master.getMetrics().recordRequest(error, attempts);
+    if (error != ModbusError::OK) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        m_master.reportError(RequestError{
+            .error = error,
+            .slaveAddress = request.slaveAddress,
+            .functionCode = request.functionCode,
+            .exceptionCode = toExceptionCode(error),
+            .regStart = request.regStart,
+            .regSize = request.regSize,
+            .attempts = attempts,
+            .elapsedUs = static_cast<uint32_t>(std::min<int64_t>(elapsed.count(), UINT32_MAX))
+        });
+    }
+}
+
+ModbusError SlaveDevice::enqueue(AsyncRequest request, RequestPriority priority) const {
+    RequestQueue* requestQueue = m_master.getRequestQueue();
+    if (!requestQueue) {
+        return ModbusError::INVALID_STATE;
+    }
+    return requestQueue->enqueue(std::move(request), priority);
+}
+
+ModbusError SlaveDevice::readBlock(RegisterType type, uint16_t reg, uint16_t size, void* buffer) const {
+    ModbusRequest request {
+        .slaveAddress = m_address,
+        .functionCode = static_cast<uint8_t>(type),
+        .regStart = reg,
+        .regSize = size
+    };
+    return sendRequest(request, buffer);
+}
+
+ModbusError SlaveDevice::writeBlock(RegisterType type, uint16_t reg, uint16_t size, const void* buffer) const {
+    ModbusRequest request {
+        .slaveAddress = m_address,
+        .functionCode = 0x10,
+        .regStart = reg,
+        .regSize = size
+    };
+    if (type == RegisterType::HOLDING) {
+        if (size == 1) {
+            request.functionCode = 0x06;
+        }
+        return sendRequest(request, const_cast<void*>(buffer));
+    }
+    if (type != RegisterType::COIL) {
+        return ModbusError::INVALID_ARG;
+    }
+    if (size == 1) {
+        request.functionCode = 0x05;
+        uint16_t value = (*static_cast<const uint8_t*>(buffer) & 1) ? 0xFF00 : 0x0000;
+        return sendRequest(request, &value);
+    }
+    request.functionCode = 0x0F;
+    return sendRequest(request, const_cast<void*>(buffer));
+}
+
+ModbusError SlaveDevice::readArray(RegisterType type, uint16_t reg, void* data, size_t count,
+                                   size_t elementSize, RegisterCodec codec) const {
+    if (count == 0 || reg + count * elementSize > UINT16_MAX + 1) {
+        return ModbusError::INVALID_ARG;
+    }
+    auto* registers = static_cast<uint16_t*>(data);
+    // Requests are split at element boundaries, so no element is torn across two requests unless it is too large
+    const size_t perRequest = splitSize(MAX_READ_REGISTERS, elementSize);
+    for (size_t offset = 0; offset < count * elementSize; offset += perRequest) {
+        auto size = static_cast<uint16_t>(std::min(perRequest, count * elementSize - offset));
+        ModbusError error = readBlock(type, static_cast<uint16_t>(reg + offset), size, registers + offset);
+        if (error != ModbusError::OK) {
+            return error;
+        }
+        if (codec != nullptr) {
+            codec(registers + offset, registers + offset, size / elementSize);
         }
     }
+    return ModbusError::OK;
+}
+
+ModbusError SlaveDevice::writeArray(uint16_t reg, const void* data, size_t count, size_t elementSize,
+                                    RegisterCodec codec) const {
+    if (count == 0 || reg + count * elementSize > UINT16_MAX + 1) {
+        return ModbusError::INVALID_ARG;
+    }
+    const auto* registers = static_cast<const uint16_t*>(data);
+    const size_t perRequest = splitSize(MAX_WRITE_REGISTERS, elementSize);
+    // The caller's elements are not modified, converted elements are sent from a buffer
+    uint16_t buffer[MAX_WRITE_REGISTERS];
+    for (size_t offset = 0; offset < count * elementSize; offset += perRequest) {
+        auto size = static_cast<uint16_t>(std::min(perRequest, count * elementSize - offset));
+        const uint16_t* source = registers + offset;
+        if (codec != nullptr) {
+            codec(source, buffer, size / elementSize);
+            source = buffer;
+        }
+        ModbusError error = writeBlock(RegisterType::HOLDING, static_cast<uint16_t>(reg + offset), size, source);
+        if (error != ModbusError::OK) {
+            return error;
+        }
+    }
+    return ModbusError::OK;
+}
+
+ModbusError SlaveDevice::readBits(RegisterType type, uint16_t reg, uint8_t* data, size_t count) const {
+    if (count == 0 || reg + count > UINT16_MAX + 1) {
+        return ModbusError::INVALID_ARG;
+    }
+    static_assert(MAX_READ_BITS % 8 == 0 && MAX_WRITE_BITS % 8 == 0, "Requests must start on a byte boundary");
+    for (size_t offset = 0; offset < count; offset += MAX_READ_BITS) {
+        auto size = static_cast<uint16_t>(std::min<size_t>(MAX_READ_BITS, count - offset));
+        ModbusError error = readBlock(type, static_cast<uint16_t>(reg + offset), size, data + offset / 8);
+        if (error != ModbusError::OK) {
+            return error;
+        }
+    }
+    return ModbusError::OK;
+}
+
+ModbusError SlaveDevice::writeBits(uint16_t reg, const uint8_t* data, size_t count) const {
+    if (count == 0 || reg + count > UINT16_MAX + 1) {
+        return ModbusError::INVALID_ARG;
+    }
+    for (size_t offset = 0; offset < count; offset += MAX_WRITE_BITS) {
+        auto size = static_cast<uint16_t>(std::min<size_t>(MAX_WRITE_BITS, count - offset));
+        ModbusError error = writeBlock(RegisterType::COIL, static_cast<uint16_t>(reg + offset), size, data + offset / 8);
+        if (error != ModbusError::OK) {
+            return error;
+        }
+    }
+    return ModbusError::OK;
+}
+
+ModbusError SlaveDevice::read(ReadPlan& plan) const {
+    ModbusError result = ModbusError::OK;
+    // MAX_READ_BITS packed into bytes need exactly as much space as MAX_READ_REGISTERS
+    uint16_t buffer[MAX_READ_REGISTERS];
+    for (const ReadBlock& block : plan.getBlocks()) {
+        ModbusError error = readBlock(block.type, block.regStart, block.regSize, buffer);
+        plan.scatter(block, buffer, error);
+        if (result == ModbusError::OK) {
+            result = error;
+        }
+    }
+    return result;
+}
+
+const RttEstimator& SlaveDevice::getRttEstimator() const {
+    return m_rtt;
+}
+
+RequestMetrics& SlaveDevice::getMetrics() const {
+    return m_metrics;
+}
+
+DeviceHealth& SlaveDevice::getHealth() const {
+    return m_health;
+}
+
+uint8_t SlaveDevice::getAddress() const {
+    return m_address;
 }
 
 SlaveDevice::SlaveDevice(uint8_t address, uint8_t retries, const DynamicModbusMaster& master): m_address(address), m_retries(retries), m_master(master) {
 }
 
+SlaveDevice::SlaveDevice(const SlaveDevice& other):
+        m_address(other.m_address), m_retries(other.m_retries), m_master(other.m_master), m_rtt(other.m_rtt),
+        m_metrics(other.m_metrics), m_health(other.m_health),
+        m_readWriteUnsupported(other.m_readWriteUnsupported.load(std::memory_order_relaxed)) {
+}
+
 }
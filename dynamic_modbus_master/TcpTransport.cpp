@@ -0,0 +1,375 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "TcpTransport.h"
+#include "dmm_common.h"
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace dynamic_modbus_master::transport {
+
+namespace {
+
+// Bounds the time the receive task blocks, so timeouts and stop requests are handled promptly
+constexpr int RECEIVE_POLL_MS = 10;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+void putUint16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = static_cast<uint8_t>(value >> 8);
+    buffer[1] = static_cast<uint8_t>(value);
+}
+
+uint16_t getUint16(const uint8_t* buffer) {
+    return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+}
+
+bool sendAll(int socket, const uint8_t* buffer, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(socket, buffer, size, SEND_FLAGS);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        buffer += sent;
+        size -= sent;
+    }
+    return true;
+}
+}
+
+TcpTransport::TcpTransport(std::string host, uint16_t port, std::chrono::milliseconds timeout, size_t maxTransactions):
+        m_host(std::move(host)), m_port(port), m_timeout(timeout), m_transactions(maxTransactions) {
+    m_freeTransactions = xSemaphoreCreateCounting(maxTransactions, maxTransactions);
+}
+
+TcpTransport::~TcpTransport() {
+    if (m_running) {
+        stop();
+    }
+    if (m_stopped) {
+        vSemaphoreDelete(m_stopped);
+    }
+    vSemaphoreDelete(m_freeTransactions);
+}
+
+ModbusError TcpTransport::start() {
+    if (m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    if (!m_stopped) {
+        m_stopped = xSemaphoreCreateBinary();
+        if (!m_stopped) {
+            return ModbusError::FAILURE;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ModbusError error = connect();
+        if (error != ModbusError::OK) {
+            return error;
+        }
+    }
+    
+    m_running = true;
+    if (xTaskCreatePinnedToCore(task, "dmm_tcp", CONFIG_DMM_BUS_TASK_STACK_SIZE, this, CONFIG_DMM_BUS_TASK_PRIORITY,
+                                nullptr, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "An error occurred while creating the TCP receive task");
+        m_running = false;
+        disconnect(ModbusError::INVALID_STATE);
+        return ModbusError::FAILURE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError TcpTransport::stop() {
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    m_running = false;
+    xSemaphoreTake(m_stopped, portMAX_DELAY);
+    disconnect(ModbusError::INVALID_STATE);
+    return ModbusError::OK;
+}
+
+ModbusError TcpTransport::sendRequest(const ModbusRequest& request, void* data) {
+    StaticSemaphore_t completedBuffer;
+    SemaphoreHandle_t completed = xSemaphoreCreateBinaryStatic(&completedBuffer);
+    ModbusError result = ModbusError::OK;
+    
+    TickType_t wait = pdMS_TO_TICKS(std::chrono::duration_cast<std::chrono::milliseconds>(timeoutOf(request)).count());
+    ModbusError error = transmit(request, data, [&result, completed](ModbusError error) {
+        result = error;
+        xSemaphoreGive(completed);
+    }, wait);
+    if (error == ModbusError::QUEUE_FULL) {
+        error = ModbusError::TIMEOUT;
+    } else if (error == ModbusError::OK) {
+        // Every transmitted transaction is completed, at the latest by the receive task once it timed out
+        xSemaphoreTake(completed, portMAX_DELAY);
+        error = result;
+    }
+    vSemaphoreDelete(completed);
+    return error;
+}
+
+ModbusError TcpTransport::submit(const ModbusRequest& request, void* data, Completion done) {
+    return transmit(request, data, std::move(done), 0);
+}
+
+size_t TcpTransport::outstanding() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_transactions.begin(), m_transactions.end(), [](const Transaction& transaction) {
+        return transaction.active;
+    });
+}
+
+size_t TcpTransport::memoryFootprint() const {
+    return sizeof(TcpTransport) + m_transactions.capacity() * sizeof(Transaction) + m_host.capacity() +
+           (m_running ? CONFIG_DMM_BUS_TASK_STACK_SIZE : 0);
+}
+
+ModbusError TcpTransport::transmit(const ModbusRequest& request, void* data, Completion done, TickType_t wait) {
+    if (!m_running) {
+        return ModbusError::INVALID_STATE;
+    }
+    if (!data) {
+        return ModbusError::INVALID_ARG;
+    }
+    std::array<uint8_t, MAX_ADU_SIZE> frame{};
+    size_t pduSize = encodeRequestPdu(request, data, frame.data() + MBAP_HEADER_SIZE);
+    if (pduSize == 0) {
+        return ModbusError::INVALID_ARG;
+    }
+    if (xSemaphoreTake(m_freeTransactions, wait) != pdTRUE) {
+        return ModbusError::QUEUE_FULL;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ModbusError error = m_running ? ModbusError::OK : ModbusError::INVALID_STATE;
+    if (error == ModbusError::OK && m_socket < 0) {
+        error = connect();
+    }
+    if (error != ModbusError::OK) {
+        xSemaphoreGive(m_freeTransactions);
+        return error;
+    }
+    
+    // A free transaction exists, since the semaphore was taken
+    Transaction& transaction = *std::find_if(m_transactions.begin(), m_transactions.end(),
+                                             [](const Transaction& entry) { return !entry.active; });
+    uint16_t id = m_nextTransactionId++;
+    putUint16(frame.data(), id);
+    putUint16(frame.data() + 2, 0);     // Protocol identifier, always 0 for Modbus
+    putUint16(frame.data() + 4, static_cast<uint16_t>(pduSize + 1));
+    frame[6] = request.slaveAddress;
+    transaction = Transaction{true, id, request, data, Clock::now() + timeoutOf(request), std::move(done), false};
+    
+    if (!sendAll(m_socket, frame.data(), MBAP_HEADER_SIZE + pduSize)) {
+        ESP_LOGE(TAG, "Sending to %s:%u failed: %s", m_host.c_str(), m_port, std::strerror(errno));
+        release(transaction);
+        // Lets the receive task notice the broken connection and fail the other outstanding transactions
+        shutdown(m_socket, SHUT_RDWR);
+        return ModbusError::FAILURE;
+    }
+    return ModbusError::OK;
+}
+
+ModbusError TcpTransport::connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* address = nullptr;
+    std::string port = std::to_string(m_port);
+    if (getaddrinfo(m_host.c_str(), port.c_str(), &hints, &address) != 0 || !address) {
+        ESP_LOGE(TAG, "Could not resolve %s", m_host.c_str());
+        return ModbusError::ADDRESS_UNAVAILABLE;
+    }
+    
+    int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0 || ::connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+        ESP_LOGE(TAG, "Could not connect to %s:%u: %s", m_host.c_str(), m_port, std::strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        freeaddrinfo(address);
+        return ModbusError::ADDRESS_UNAVAILABLE;
+    }
+    freeaddrinfo(address);
+    
+    // Requests are small and latency matters more than the number of segments
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    timeval receiveTimeout{0, RECEIVE_POLL_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+    m_socket = fd;
+    return ModbusError::OK;
+}
+
+void TcpTransport::disconnect(ModbusError error) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_socket >= 0) {
+            close(m_socket);
+            m_socket = -1;
+        }
+        m_received = 0;
+        for (Transaction& transaction : m_transactions) {
+            transaction.failed = transaction.active;
+        }
+    }
+    completeFailed(error);
+}
+
+void TcpTransport::receive() {
+    int socket = m_socket;
+    if (socket < 0) {
+        vTaskDelay(pdMS_TO_TICKS(RECEIVE_POLL_MS));
+        return;
+    }
+    
+    ssize_t received = recv(socket, m_receiveBuffer.data() + m_received, m_receiveBuffer.size() - m_received, 0);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        ESP_LOGE(TAG, "Connection to %s:%u lost", m_host.c_str(), m_port);
+        disconnect(ModbusError::FAILURE);
+        return;
+    }
+    if (received < 0) {
+        return;
+    }
+    m_received += received;
+    
+    size_t offset = 0;
+    while (m_received - offset >= MBAP_HEADER_SIZE) {
+        const uint8_t* frame = m_receiveBuffer.data() + offset;
+        uint16_t length = getUint16(frame + 4);
+        if (getUint16(frame + 2) != 0 || length < 2 || length > MAX_PDU_SIZE + 1) {
+            // The stream can not be resynchronised after a malformed header
+            ESP_LOGE(TAG, "Received malformed MBAP header from %s:%u", m_host.c_str(), m_port);
+            disconnect(ModbusError::INVALID_RESPONSE);
+            return;
+        }
+        size_t frameSize = MBAP_HEADER_SIZE - 1 + length;
+        if (m_received - offset < frameSize) {
+            break;
+        }
+        handleResponse(frame, frameSize);
+        offset += frameSize;
+    }
+    std::memmove(m_receiveBuffer.data(), m_receiveBuffer.data() + offset, m_received - offset);
+    m_received -= offset;
+}
+
+void TcpTransport::handleResponse(const uint8_t* frame, size_t size) {
+    uint16_t id = getUint16(frame);
+    Completion done;
+    ModbusError error;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto transaction = std::find_if(m_transactions.begin(), m_transactions.end(), [id](const Transaction& entry) {
+            return entry.active && entry.id == id;
+        });
+        if (transaction == m_transactions.end()) {
+            // Late response to a transaction that already timed out
+            return;
+        }
+        if (frame[6] != transaction->request.slaveAddress) {
+            error = ModbusError::INVALID_RESPONSE;
+        } else {
+            error = decodeResponsePdu(transaction->request, frame + MBAP_HEADER_SIZE, size - MBAP_HEADER_SIZE,
+                                      transaction->data);
+        }
+        done = release(*transaction);
+    }
+    if (done) {
+        done(error);
+    }
+}
+
+void TcpTransport::expireTransactions() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Clock::time_point now = Clock::now();
+        for (Transaction& transaction : m_transactions) {
+            transaction.failed = (transaction.active && transaction.deadline <= now);
+        }
+    }
+    completeFailed(ModbusError::TIMEOUT);
+}
+
+void TcpTransport::completeFailed(ModbusError error) {
+    // One transaction at a time, so the completions are invoked without the lock held and without collecting them
+    while (true) {
+        Completion done;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto transaction = std::find_if(m_transactions.begin(), m_transactions.end(),
+                                            [](const Transaction& entry) { return entry.active && entry.failed; });
+            if (transaction == m_transactions.end()) {
+                return;
+            }
+            done = release(*transaction);
+        }
+        if (done) {
+            done(error);
+        }
+    }
+}
+
+TcpTransport::Completion TcpTransport::release(Transaction& transaction) {
+    transaction.active = false;
+    transaction.failed = false;
+    Completion done = std::move(transaction.done);
+    transaction.done = nullptr;
+    xSemaphoreGive(m_freeTransactions);
+    return done;
+}
+
+TcpTransport::Clock::duration TcpTransport::timeoutOf(const ModbusRequest& request) const {
+    if (request.timeoutMs == 0) {
+        return m_timeout;
+    }
+    return std::chrono::milliseconds(request.timeoutMs);
+}
+
+void TcpTransport::task(void* transport) {
+    auto* self = static_cast<TcpTransport*>(transport);
+    while (self->m_running) {
+        self->receive();
+        self->expireTransactions();
+    }
+    xSemaphoreGive(self->m_stopped);
+    vTaskDelete(nullptr);
+}
+}
@@ -0,0 +1,154 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "WriteBehindBuffer.h"
+
+namespace dynamic_modbus_master::slave {
+
+namespace {
+
+template<typename Value>
+auto findRegister(std::vector<Value>& values, uint16_t reg) {
+    return std::lower_bound(values.begin(), values.end(), reg, [](const Value& value, uint16_t target) {
+        return value.reg < target;
+    });
+}
+}
+
+WriteBehindBuffer::WriteBehindBuffer(const SlaveDevice& device, std::chrono::milliseconds maxDelay):
+        m_device(device), m_maxDelay(maxDelay) {
+}
+
+ModbusError WriteBehindBuffer::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ModbusError holdingError = flush(m_holding);
+    ModbusError coilError = flush(m_coils);
+    
+    bool remaining = !m_holding.pending.empty() || !m_coils.pending.empty();
+    m_deadline = remaining ? Clock::now() + m_maxDelay : Clock::time_point::max();
+    return holdingError != ModbusError::OK ? holdingError : coilError;
+}
+
+ModbusError WriteBehindBuffer::poll(Clock::time_point now) {
+    if (deadline() > now) {
+        return ModbusError::OK;
+    }
+    return flush();
+}
+
+WriteBehindBuffer::Clock::time_point WriteBehindBuffer::deadline() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deadline;
+}
+
+size_t WriteBehindBuffer::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_holding.pending.size() + m_coils.pending.size();
+}
+
+WriteStatistics WriteBehindBuffer::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void WriteBehindBuffer::stage(RegisterType type, uint16_t reg, uint16_t count, const uint16_t* values) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Table& table = (type == RegisterType::HOLDING ? m_holding : m_coils);
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t current = reg + i;
+        m_statistics.writes++;
+        auto pending = findRegister(table.pending, current);
+        bool isPending = pending != table.pending.end() && pending->reg == current;
+        auto confirmed = findRegister(table.confirmed, current);
+        if (confirmed != table.confirmed.end() && confirmed->reg == current && confirmed->value == values[i]) {
+            // The device already holds this value, a different value that is still pending is superseded
+            if (isPending) {
+                table.pending.erase(pending);
+            }
+            m_statistics.deduplicated++;
+        } else if (isPending) {
+            pending->value = values[i];
+        } else {
+            table.pending.insert(pending, Value{current, values[i]});
+        }
+    }
+    
+    bool remaining = !m_holding.pending.empty() || !m_coils.pending.empty();
+    if (!remaining) {
+        m_deadline = Clock::time_point::max();
+    } else if (m_deadline == Clock::time_point::max()) {
+        m_deadline = Clock::now() + m_maxDelay;
+    }
+}
+
+ModbusError WriteBehindBuffer::flush(Table& table) {
+    const bool bits = isBitType(table.type);
+    const size_t maxSize = bits ? MAX_WRITE_BITS : MAX_WRITE_REGISTERS;
+    // MAX_WRITE_BITS packed into bytes need less space than MAX_WRITE_REGISTERS
+    uint16_t buffer[MAX_WRITE_REGISTERS];
+    auto* bytes = reinterpret_cast<uint8_t*>(buffer);
+    
+    ModbusError result = ModbusError::OK;
+    std::vector<Value> failed;
+    size_t first = 0;
+    while (first < table.pending.size()) {
+        // Extend the run as long as the registers are adjacent and fit into a single request
+        size_t last = first + 1;
+        while (last < table.pending.size() && last - first < maxSize &&
+               table.pending[last].reg == table.pending[last - 1].reg + 1) {
+            last++;
+        }
+        
+        uint16_t size = last - first;
+        if (bits) {
+            std::memset(bytes, 0, (size + 7) / 8);
+        }
+        for (uint16_t i = 0; i < size; i++) {
+            if (bits) {
+                bytes[i / 8] |= static_cast<uint8_t>((table.pending[first + i].value & 1) << (i % 8));
+            } else {
+                buffer[i] = table.pending[first + i].value;
+            }
+        }
+        
+        ModbusError error = m_device.writeBlock(table.type, table.pending[first].reg, size, buffer);
+        m_statistics.frames++;
+        if (error == ModbusError::OK) {
+            for (size_t i = first; i < last; i++) {
+                auto confirmed = findRegister(table.confirmed, table.pending[i].reg);
+                if (confirmed != table.confirmed.end() && confirmed->reg == table.pending[i].reg) {
+                    confirmed->value = table.pending[i].value;
+                } else {
+                    table.confirmed.insert(confirmed, table.pending[i]);
+                }
+            }
+        } else {
+            m_statistics.failures++;
+            failed.insert(failed.end(), table.pending.begin() + first, table.pending.begin() + last);
+            if (result == ModbusError::OK) {
+                result = error;
+            }
+        }
+        first = last;
+    }
+    table.pending = std::move(failed);
+    return result;
+}
+}
@@ -0,0 +1,241 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <DynamicModbusMaster.h>
+#include <ModbusErrorHelper.h>
+#include <SimulatedTransport.h>
+#include <SlaveDevice.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+using dynamic_modbus_master::ModbusError;
+using dynamic_modbus_master::slave::SlaveDevice;
+using dynamic_modbus_master::slave::SlaveReturn;
+
+namespace {
+std::atomic<size_t> g_allocations = 0;
+}
+
+// Counts every allocation of the benchmark and the library, so allocations on the request path show up in the output
+void* operator new(size_t size) {
+    g_allocations++;
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// GCC does not recognise malloc as the allocation function of the replaced operator new
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+#pragma GCC diagnostic pop
+
+namespace {
+
+/**
+ * @brief Block of N holding or input registers, used to vary the payload size of register requests.
+ */
+template<size_t N>
+struct RegisterBlock {
+    uint16_t registers[N];
+};
+
+using Operation = std::function<ModbusError(SlaveDevice&)>;
+
+constexpr std::array<size_t, 3> DEVICE_COUNTS = {1, 10, 100};
+constexpr std::array<uint32_t, 3> BAUD_RATES = {0, 115200, 9600};
+constexpr uint16_t TABLE_SIZE = 128;
+
+dynamic_modbus_master::DynamicModbusMaster g_master;
+dynamic_modbus_master::transport::SimulatedTransport* g_transport = nullptr;
+std::vector<SlaveDevice> g_devices;
+StaticSemaphore_t g_completedBuffer;
+SemaphoreHandle_t g_completed = nullptr;
+size_t g_requestAllocations = 0;
+
+void runCase(const char* name, uint16_t payload, size_t deviceCount, uint32_t baudRate, const Operation& operation) {
+    const size_t iterations = (baudRate == 0 ? CONFIG_BENCHMARK_ITERATIONS : CONFIG_BENCHMARK_THROTTLED_ITERATIONS);
+    std::vector<uint32_t> latencies;
+    latencies.reserve(iterations);
+    size_t failures = 0;
+    
+    g_transport->setBaudRate(baudRate);
+    g_transport->resetWireStatistics();
+    
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        SlaveDevice& device = g_devices[i % deviceCount];
+        auto requestStart = std::chrono::steady_clock::now();
+        ModbusError error = operation(device);
+        auto requestEnd = std::chrono::steady_clock::now();
+        if (error != ModbusError::OK) {
+            failures++;
+        }
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(requestEnd - requestStart).count());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    allocations = g_allocations - allocations;
+    g_requestAllocations += allocations;
+    
+    std::sort(latencies.begin(), latencies.end());
+    dynamic_modbus_master::transport::WireStatistics wire = g_transport->getWireStatistics();
+    
+    std::printf("%-20s %7u %7zu %7" PRIu32 " %12.0f %10.2f %10.2f %9.1f %9.1f %8zu %8zu\n",
+                name, payload, deviceCount, baudRate,
+                iterations / seconds,
+                latencies[latencies.size() / 2] / 1000.0,
+                latencies[(latencies.size() * 99) / 100] / 1000.0,
+                static_cast<double>(wire.bytesSent + wire.bytesReceived) / wire.requests,
+                (wire.busTimeUs / 1000000.0) / seconds * 100.0,
+                failures,
+                allocations);
+}
+
+void runAll(const char* name, uint16_t payload, const Operation& operation) {
+    for (uint32_t baudRate : BAUD_RATES) {
+        for (size_t deviceCount : DEVICE_COUNTS) {
+            runCase(name, payload, deviceCount, baudRate, operation);
+        }
+    }
+}
+
+template<size_t N>
+void benchmarkRegisters() {
+    runAll("readHolding", N, [](SlaveDevice& device) {
+        return device.readHolding<RegisterBlock<N>>(0).error;
+    });
+    runAll("writeHolding", N, [](SlaveDevice& device) {
+        return device.writeHolding(0, RegisterBlock<N>{});
+    });
+    runAll("readInputs", N, [](SlaveDevice& device) {
+        return device.readInputs<RegisterBlock<N>>(0).error;
+    });
+}
+
+template<size_t N>
+void benchmarkAsync() {
+    runAll("readHoldingAsync", N, [](SlaveDevice& device) {
+        ModbusError result = ModbusError::OK;
+        ModbusError error = device.readHoldingAsync<RegisterBlock<N>>(0, [&result](SlaveReturn<RegisterBlock<N>> value) {
+            result = value.error;
+            xSemaphoreGive(g_completed);
+        });
+        if (error != ModbusError::OK) {
+            return error;
+        }
+        xSemaphoreTake(g_completed, portMAX_DELAY);
+        return result;
+    });
+}
+
+template<typename T>
+void benchmarkBits() {
+    constexpr uint16_t bits = (std::is_same_v<T, bool> ? 1 : sizeof(T) * 8);
+    runAll("readCoils", bits, [](SlaveDevice& device) {
+        return device.readCoils<T>(0, bits).error;
+    });
+    runAll("writeCoils", bits, [](SlaveDevice& device) {
+        return device.writeCoils<T>(0, T{}, bits);
+    });
+    runAll("readDiscreteInputs", bits, [](SlaveDevice& device) {
+        return device.readDiscreteInputs<T>(0).error;
+    });
+}
+}
+
+extern "C" void app_main(void) {
+    auto transport = std::make_unique<dynamic_modbus_master::transport::SimulatedTransport>();
+    g_transport = transport.get();
+    
+    size_t maxDevices = *std::max_element(DEVICE_COUNTS.begin(), DEVICE_COUNTS.end());
+    g_devices.reserve(maxDevices);
+    for (size_t i = 0; i < maxDevices; i++) {
+        uint8_t address = static_cast<uint8_t>(i + 1);
+        g_transport->addSlave(address, TABLE_SIZE);
+        g_devices.emplace_back(address, 0, g_master);
+    }
+    
+    ModbusError error = g_master.initialise(std::move(transport));
+    if (error == ModbusError::OK) {
+        error = g_master.start();
+    }
+    if (error == ModbusError::OK) {
+        error = g_master.startRequestQueue();
+    }
+    if (error != ModbusError::OK) {
+        std::printf("Starting the simulated bus failed: %s\n",
+                    dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
+        return;
+    }
+    
+    g_completed = xSemaphoreCreateBinaryStatic(&g_completedBuffer);
+    
+    dynamic_modbus_master::MemoryFootprint footprint = g_master.getMemoryFootprint();
+    std::printf("RAM [bytes]: master %zu, transport %zu, request queue %zu, per device %zu\n\n",
+                footprint.master, footprint.transport, footprint.requestQueue, footprint.device);
+    
+    std::printf("%-20s %7s %7s %7s %12s %10s %10s %9s %9s %8s %8s\n",
+                "operation", "payload", "devices", "baud", "requests/s", "p50 [us]", "p99 [us]",
+                "bytes/req", "bus [%]", "failures", "allocs");
+    
+    benchmarkRegisters<1>();
+    benchmarkRegisters<2>();
+    benchmarkRegisters<8>();
+    benchmarkRegisters<32>();
+    benchmarkRegisters<120>();
+    
+    benchmarkBits<bool>();
+    benchmarkBits<uint16_t>();
+    benchmarkBits<uint64_t>();
+    
+    benchmarkAsync<1>();
+    benchmarkAsync<2>();
+    
+    std::printf("\nHeap allocations while sending requests: %zu\n", g_requestAllocations);
+#if CONFIG_DMM_STATIC_POOLS
+    if (g_requestAllocations != 0) {
+        std::printf("FAILED: The request path allocated memory although CONFIG_DMM_STATIC_POOLS is enabled\n");
+        std::abort();
+    }
+#endif
+    
+    g_master.stopRequestQueue();
+    g_master.stop();
+}
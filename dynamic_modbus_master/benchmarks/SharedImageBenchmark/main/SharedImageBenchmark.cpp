@@ -0,0 +1,221 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <DynamicModbusMaster.h>
+#include <ModbusErrorHelper.h>
+#include <ProcessImage.h>
+#include <SharedImageExporter.h>
+#include <SharedImageReader.h>
+#include <SimulatedTransport.h>
+#include <SlaveDevice.h>
+#include <sdkconfig.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+#include <vector>
+
+using dynamic_modbus_master::ModbusError;
+using dynamic_modbus_master::RegisterType;
+using dynamic_modbus_master::slave::SlaveDevice;
+
+namespace {
+
+/**
+ * @brief Block of N holding registers, read as a single point of the process image.
+ */
+template<size_t N>
+struct RegisterBlock {
+    uint16_t registers[N];
+};
+
+/**
+ * @brief What the reader observed during a case.
+ */
+struct ReaderResult {
+    std::atomic<bool> ready = false;
+    size_t reads = 0;
+    size_t torn = 0;
+    size_t failures = 0;
+    double seconds = 0;
+    std::vector<uint32_t> latencies;
+};
+
+constexpr std::array<size_t, 3> DEVICE_COUNTS = {1, 10, 50};
+constexpr uint16_t TABLE_SIZE = 128;
+constexpr size_t MAX_READ_SAMPLES = 1000000;
+
+dynamic_modbus_master::DynamicModbusMaster g_master;
+dynamic_modbus_master::transport::SimulatedTransport* g_transport = nullptr;
+std::deque<SlaveDevice> g_devices;
+size_t g_torn = 0;
+
+/**
+ * @brief Read the registers of all devices from the segment until the updates are done.
+ *
+ * @details The reader maps the segment on its own, just like a reader in another process. Every update writes the same
+ * value to all registers of a device, so registers that differ within a single read are torn.
+ */
+void readSegment(size_t deviceCount, uint16_t registerCount, const std::atomic<bool>& updating, ReaderResult& result) {
+    dynamic_modbus_master::SharedImageReader reader;
+    if (reader.open(CONFIG_BENCHMARK_SEGMENT_NAME) != ModbusError::OK) {
+        result.failures++;
+        result.ready = true;
+        return;
+    }
+    result.latencies.reserve(MAX_READ_SAMPLES);
+    uint16_t registers[TABLE_SIZE];
+    result.ready = true;
+    auto readStart = std::chrono::steady_clock::now();
+    while (updating.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < deviceCount; i++) {
+            auto start = std::chrono::steady_clock::now();
+            ModbusError error = reader.readRegisters(static_cast<uint8_t>(i + 1), RegisterType::HOLDING, 0,
+                                                     registerCount, registers);
+            auto end = std::chrono::steady_clock::now();
+            result.reads++;
+            if (result.latencies.size() < MAX_READ_SAMPLES) {
+                result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+            // Blocks that were not updated yet are reported with ModbusError::INVALID_STATE
+            if (error == ModbusError::INVALID_STATE) {
+                continue;
+            }
+            if (error != ModbusError::OK) {
+                result.failures++;
+            } else if (!std::all_of(registers, registers + registerCount, [&](uint16_t value) {
+                           return value == registers[0];
+                       })) {
+                result.torn++;
+            }
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+}
+
+template<uint16_t N>
+void runCase(size_t deviceCount) {
+    dynamic_modbus_master::ProcessImage image;
+    for (size_t i = 0; i < deviceCount; i++) {
+        image.add<RegisterBlock<N>>(g_devices[i], RegisterType::HOLDING, 0);
+    }
+    dynamic_modbus_master::SharedImageExporter exporter(image);
+    ModbusError error = exporter.open(CONFIG_BENCHMARK_SEGMENT_NAME);
+    if (error != ModbusError::OK) {
+        std::printf("Exporting the process image failed: %s\n",
+                    dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
+        std::abort();
+    }
+    
+    std::atomic<bool> updating = true;
+    ReaderResult reader;
+    std::thread readerThread(readSegment, deviceCount, N, std::cref(updating), std::ref(reader));
+    // The updates only start once the reader mapped the segment, so every update overlaps with reads
+    while (!reader.ready) {
+        std::this_thread::yield();
+    }
+    
+    std::vector<uint32_t> latencies;
+    latencies.reserve(CONFIG_BENCHMARK_UPDATES);
+    size_t failures = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t update = 0; update < CONFIG_BENCHMARK_UPDATES; update++) {
+        // The simulated tables are only changed between updates, no request is sent concurrently
+        for (size_t i = 0; i < deviceCount; i++) {
+            std::vector<uint16_t>& table = g_transport->getSlave(static_cast<uint8_t>(i + 1))->holdingRegisters;
+            std::fill(table.begin(), table.begin() + N, static_cast<uint16_t>(update));
+        }
+        auto updateStart = std::chrono::steady_clock::now();
+        if (image.update() != ModbusError::OK) {
+            failures++;
+        }
+        auto updateEnd = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(updateEnd - updateStart).count());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    updating = false;
+    readerThread.join();
+    exporter.close();
+    
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(reader.latencies.begin(), reader.latencies.end());
+    auto percentile = [](const std::vector<uint32_t>& sorted, size_t percent) {
+        return sorted.empty() ? 0u : sorted[(sorted.size() * percent) / 100];
+    };
+    g_torn += reader.torn;
+    std::printf("%7zu %9u %10.0f %10.2f %10.2f %12.0f %10u %10u %6zu %8zu\n",
+                deviceCount, N,
+                CONFIG_BENCHMARK_UPDATES / seconds,
+                percentile(latencies, 50) / 1000.0, percentile(latencies, 99) / 1000.0,
+                reader.seconds > 0 ? reader.reads / reader.seconds : 0.0,
+                percentile(reader.latencies, 50), percentile(reader.latencies, 99),
+                reader.torn, failures + reader.failures);
+}
+
+template<uint16_t N>
+void runAll() {
+    for (size_t deviceCount : DEVICE_COUNTS) {
+        runCase<N>(deviceCount);
+    }
+}
+}
+
+extern "C" void app_main(void) {
+    auto transport = std::make_unique<dynamic_modbus_master::transport::SimulatedTransport>();
+    g_transport = transport.get();
+    
+    size_t maxDevices = *std::max_element(DEVICE_COUNTS.begin(), DEVICE_COUNTS.end());
+    for (size_t i = 0; i < maxDevices; i++) {
+        uint8_t address = static_cast<uint8_t>(i + 1);
+        g_transport->addSlave(address, TABLE_SIZE);
+        g_devices.emplace_back(address, 0, g_master);
+    }
+    
+    ModbusError error = g_master.initialise(std::move(transport));
+    if (error == ModbusError::OK) {
+        error = g_master.start();
+    }
+    if (error != ModbusError::OK) {
+        std::printf("Starting the simulated bus failed: %s\n",
+                    dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
+        return;
+    }
+    
+    std::printf("%7s %9s %10s %10s %10s %12s %10s %10s %6s %8s\n",
+                "devices", "registers", "updates/s", "p50 [us]", "p99 [us]",
+                "reads/s", "p50 [ns]", "p99 [ns]", "torn", "failures");
+    
+    runAll<2>();
+    runAll<8>();
+    runAll<64>();
+    runAll<120>();
+    
+    std::printf("\nTorn reads: %zu\n", g_torn);
+    if (g_torn != 0) {
+        std::printf("FAILED: A reader observed a block while it was written\n");
+        std::abort();
+    }
+    
+    g_master.stop();
+}
@@ -0,0 +1,226 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "LoopbackServer.h"
+#include <ModbusPdu.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+
+using dynamic_modbus_master::ModbusError;
+using dynamic_modbus_master::ModbusRequest;
+
+namespace {
+
+constexpr size_t MBAP_HEADER_SIZE = 7;
+
+void putUint16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = static_cast<uint8_t>(value >> 8);
+    buffer[1] = static_cast<uint8_t>(value);
+}
+
+uint16_t getUint16(const uint8_t* buffer) {
+    return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+}
+}
+
+LoopbackServer::LoopbackServer(dynamic_modbus_master::transport::SimulatedTransport& slaves, uint16_t port,
+                               std::chrono::microseconds serviceTime):
+        m_slaves(slaves), m_port(port), m_serviceTime(serviceTime) {
+}
+
+LoopbackServer::~LoopbackServer() {
+    stop();
+}
+
+bool LoopbackServer::start() {
+    m_listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // Lets accept and recv return regularly, so the server can be stopped
+    timeval timeout{0, 10000};
+    setsockopt(m_listener, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(m_port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(m_listener, 1) != 0) {
+        close(m_listener);
+        m_listener = -1;
+        return false;
+    }
+    m_running = true;
+    m_receiver = std::thread(&LoopbackServer::receive, this);
+    m_sender = std::thread(&LoopbackServer::send, this);
+    return true;
+}
+
+void LoopbackServer::stop() {
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    m_responsesChanged.notify_all();
+    m_receiver.join();
+    m_sender.join();
+    close(m_listener);
+}
+
+void LoopbackServer::setLatency(std::chrono::microseconds latency) {
+    m_latencyUs = latency.count();
+}
+
+void LoopbackServer::receive() {
+    std::vector<uint8_t> buffer(4096);
+    size_t received = 0;
+    while (m_running) {
+        if (m_client < 0) {
+            int client = accept(m_listener, nullptr, nullptr);
+            if (client >= 0) {
+                int noDelay = 1;
+                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                timeval timeout{0, 10000};
+                setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                received = 0;
+                m_client = client;
+            }
+            continue;
+        }
+        
+        ssize_t count = recv(m_client, buffer.data() + received, buffer.size() - received, 0);
+        if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            close(m_client);
+            m_client = -1;
+            m_responses.clear();
+            continue;
+        }
+        if (count < 0) {
+            continue;
+        }
+        Clock::time_point arrival = Clock::now();
+        received += count;
+        
+        size_t offset = 0;
+        while (received - offset >= MBAP_HEADER_SIZE) {
+            size_t frameSize = MBAP_HEADER_SIZE - 1 + getUint16(buffer.data() + offset + 4);
+            if (received - offset < frameSize) {
+                break;
+            }
+            std::vector<uint8_t> response = process(buffer.data() + offset);
+            offset += frameSize;
+            if (response.empty()) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_responses.push_back(Response{arrival + std::chrono::microseconds(m_latencyUs), std::move(response)});
+            m_responsesChanged.notify_all();
+        }
+        std::memmove(buffer.data(), buffer.data() + offset, received - offset);
+        received -= offset;
+    }
+    if (m_client >= 0) {
+        close(m_client);
+        m_client = -1;
+    }
+}
+
+void LoopbackServer::send() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        if (m_responses.empty()) {
+            m_responsesChanged.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+        if (m_responses.front().due > Clock::now()) {
+            m_responsesChanged.wait_until(lock, m_responses.front().due);
+            continue;
+        }
+        Response response = std::move(m_responses.front());
+        m_responses.pop_front();
+        ::send(m_client, response.frame.data(), response.frame.size(), MSG_NOSIGNAL);
+    }
+}
+
+std::vector<uint8_t> LoopbackServer::process(const uint8_t* frame) {
+    auto serviceEnd = Clock::now() + m_serviceTime;
+    
+    const uint8_t* pdu = frame + MBAP_HEADER_SIZE;
+    ModbusRequest request{
+            .slaveAddress = frame[6],
+            .functionCode = pdu[0],
+            .regStart = getUint16(pdu + 1),
+            .regSize = getUint16(pdu + 3)
+    };
+    uint16_t data[dynamic_modbus_master::transport::MAX_PDU_SIZE]{};
+    switch (request.functionCode) {
+        case 0x05:
+        case 0x06:
+            data[0] = request.regSize;
+            request.regSize = 1;
+            break;
+        case 0x0F:
+            std::memcpy(data, pdu + 6, pdu[5]);
+            break;
+        case 0x10:
+            for (uint16_t i = 0; i < request.regSize && i < dynamic_modbus_master::MAX_WRITE_REGISTERS; i++) {
+                data[i] = getUint16(pdu + 6 + i * 2);
+            }
+            break;
+        default:
+            break;
+    }
+    ModbusError error = m_slaves.sendRequest(request, data);
+    
+    std::vector<uint8_t> response(frame, frame + MBAP_HEADER_SIZE);
+    if (error == ModbusError::TIMEOUT) {
+        response.clear();
+    } else if (error != ModbusError::OK) {
+        response.push_back(request.functionCode | 0x80);
+        response.push_back(static_cast<uint8_t>(error) - 10);
+    } else if (request.functionCode <= 0x02) {
+        response.push_back(request.functionCode);
+        response.push_back(static_cast<uint8_t>((request.regSize + 7) / 8));
+        auto* bytes = reinterpret_cast<const uint8_t*>(data);
+        response.insert(response.end(), bytes, bytes + response.back());
+    } else if (request.functionCode <= 0x04) {
+        response.push_back(request.functionCode);
+        response.push_back(static_cast<uint8_t>(request.regSize * 2));
+        for (uint16_t i = 0; i < request.regSize; i++) {
+            response.push_back(static_cast<uint8_t>(data[i] >> 8));
+            response.push_back(static_cast<uint8_t>(data[i]));
+        }
+    } else {
+        // Writing requests are answered with an echo of the first five bytes of the request
+        response.insert(response.end(), pdu, pdu + 5);
+    }
+    if (!response.empty()) {
+        putUint16(response.data() + 4, static_cast<uint16_t>(response.size() - MBAP_HEADER_SIZE + 1));
+    }
+    
+    while (Clock::now() < serviceEnd) {
+        // Busy wait, sleeping is too coarse for service times in the order of microseconds
+    }
+    return response;
+}
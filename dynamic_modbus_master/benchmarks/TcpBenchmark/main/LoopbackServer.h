@@ -0,0 +1,87 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef TCP_BENCHMARK_LOOPBACKSERVER_H
+#define TCP_BENCHMARK_LOOPBACKSERVER_H
+
+#include <SimulatedTransport.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Modbus TCP server on the loopback interface, answering requests from a SimulatedTransport.
+ *
+ * @details Requests are processed one after another, each taking the configured service time. The response is sent
+ * once the configured latency has passed since the request was received, independent of other requests, which
+ * emulates the round-trip time of a network between client and server.
+ */
+class LoopbackServer {
+public:
+    LoopbackServer(dynamic_modbus_master::transport::SimulatedTransport& slaves, uint16_t port,
+                   std::chrono::microseconds serviceTime);
+    
+    ~LoopbackServer();
+    
+    /**
+     * @brief Start listening, a single client is served at a time.
+     *
+     * @return true if the server is listening.
+     */
+    bool start();
+    
+    void stop();
+    
+    void setLatency(std::chrono::microseconds latency);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Response {
+        Clock::time_point due;
+        std::vector<uint8_t> frame;
+    };
+    
+    dynamic_modbus_master::transport::SimulatedTransport& m_slaves;
+    uint16_t m_port;
+    std::chrono::microseconds m_serviceTime;
+    std::atomic<int64_t> m_latencyUs = 0;
+    std::atomic<bool> m_running = false;
+    int m_listener = -1;
+    std::atomic<int> m_client = -1;
+    std::thread m_receiver;
+    std::thread m_sender;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_responsesChanged;
+    std::deque<Response> m_responses;
+    
+    void receive();
+    
+    void send();
+    
+    std::vector<uint8_t> process(const uint8_t* frame);
+};
+
+#endif //TCP_BENCHMARK_LOOPBACKSERVER_H
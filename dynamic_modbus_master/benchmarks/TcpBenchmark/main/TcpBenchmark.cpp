@@ -0,0 +1,124 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "LoopbackServer.h"
+#include <ModbusErrorHelper.h>
+#include <SimulatedTransport.h>
+#include <TcpTransport.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+using dynamic_modbus_master::ModbusError;
+using dynamic_modbus_master::ModbusRequest;
+using dynamic_modbus_master::transport::TcpTransport;
+
+namespace {
+
+constexpr std::array<uint32_t, 3> LATENCIES_US = {0, 1000, 5000};
+constexpr std::array<size_t, 4> DEPTHS = {1, 4, 16, 64};
+constexpr uint8_t SLAVE_ADDRESS = 1;
+constexpr uint16_t REGISTERS = 8;
+
+/**
+ * @brief Send all requests of a case with at most `depth` requests outstanding at the same time.
+ *
+ * @return The number of failed requests.
+ */
+size_t runPipelined(TcpTransport& transport, size_t depth) {
+    const ModbusRequest request{.slaveAddress = SLAVE_ADDRESS, .functionCode = 0x03, .regStart = 0, .regSize = REGISTERS};
+    std::atomic<size_t> failures = 0;
+    
+    if (depth == 1) {
+        uint16_t data[REGISTERS];
+        for (size_t i = 0; i < CONFIG_BENCHMARK_REQUESTS; i++) {
+            if (transport.sendRequest(request, data) != ModbusError::OK) {
+                failures++;
+            }
+        }
+        return failures;
+    }
+    
+    // Every outstanding request owns a slot of the window, which is returned by its completion
+    SemaphoreHandle_t window = xSemaphoreCreateCounting(depth, depth);
+    std::vector<std::array<uint16_t, REGISTERS>> buffers(depth);
+    for (size_t i = 0; i < CONFIG_BENCHMARK_REQUESTS; i++) {
+        xSemaphoreTake(window, portMAX_DELAY);
+        ModbusError error = transport.submit(request, buffers[i % depth].data(), [&failures, window](ModbusError error) {
+            if (error != ModbusError::OK) {
+                failures++;
+            }
+            xSemaphoreGive(window);
+        });
+        if (error != ModbusError::OK) {
+            failures++;
+            xSemaphoreGive(window);
+        }
+    }
+    for (size_t i = 0; i < depth; i++) {
+        xSemaphoreTake(window, portMAX_DELAY);
+    }
+    vSemaphoreDelete(window);
+    return failures;
+}
+}
+
+extern "C" void app_main(void) {
+    dynamic_modbus_master::transport::SimulatedTransport slaves;
+    slaves.addSlave(SLAVE_ADDRESS, 128);
+    slaves.start();
+    
+    LoopbackServer server(slaves, CONFIG_BENCHMARK_PORT, std::chrono::microseconds(CONFIG_BENCHMARK_SERVICE_TIME_US));
+    if (!server.start()) {
+        std::printf("The loopback server could not listen on port %d\n", CONFIG_BENCHMARK_PORT);
+        return;
+    }
+    
+    size_t maxDepth = DEPTHS.back();
+    TcpTransport transport("127.0.0.1", CONFIG_BENCHMARK_PORT, std::chrono::milliseconds(1000), maxDepth);
+    ModbusError error = transport.start();
+    if (error != ModbusError::OK) {
+        std::printf("Connecting to the loopback server failed: %s\n",
+                    dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
+        return;
+    }
+    
+    std::printf("Server limit: %.0f requests/s\n", 1000000.0 / std::max(CONFIG_BENCHMARK_SERVICE_TIME_US, 1));
+    std::printf("%12s %7s %12s %8s\n", "latency [us]", "depth", "requests/s", "failures");
+    for (uint32_t latency : LATENCIES_US) {
+        server.setLatency(std::chrono::microseconds(latency));
+        for (size_t depth : DEPTHS) {
+            auto start = std::chrono::steady_clock::now();
+            size_t failures = runPipelined(transport, depth);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::printf("%12" PRIu32 " %7zu %12.0f %8zu\n", latency, depth, CONFIG_BENCHMARK_REQUESTS / seconds, failures);
+        }
+    }
+    
+    transport.stop();
+    server.stop();
+}
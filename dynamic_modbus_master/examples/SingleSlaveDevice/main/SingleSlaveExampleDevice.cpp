@@ -30,7 +30,7 @@ uint16_t SingleSlaveExampleDevice::readExampleSingleRegister() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -40,7 +40,7 @@ uint32_t SingleSlaveExampleDevice::readExampleMultipleRegisters() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -50,7 +50,7 @@ float SingleSlaveExampleDevice::readExampleFloat() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -58,28 +58,28 @@ float SingleSlaveExampleDevice::readExampleFloat() {
 void SingleSlaveExampleDevice::writeExampleSingleRegister(uint16_t data) {
     dynamic_modbus_master::ModbusError error = writeHolding(1, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 void SingleSlaveExampleDevice::writeExampleMultipleRegisters(uint32_t data) {
     dynamic_modbus_master::ModbusError error = writeHolding(2, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 void SingleSlaveExampleDevice::writeExampleFloat(float data) {
     dynamic_modbus_master::ModbusError error = writeHolding(4, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 uint16_t SingleSlaveExampleDevice::readExampleMultipleCoils() {
     dynamic_modbus_master::slave::SlaveReturn<uint16_t> slaveReturn = readCoils<uint16_t>(1, 4);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read multiple Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read multiple Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -87,14 +87,14 @@ uint16_t SingleSlaveExampleDevice::readExampleMultipleCoils() {
 void SingleSlaveExampleDevice::writeExampleMultipleCoils(uint16_t coilStates) {
     dynamic_modbus_master::ModbusError error = writeCoils(1, coilStates, 4);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write multiple Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write multiple Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 bool SingleSlaveExampleDevice::readExampleSingleCoil() {
     dynamic_modbus_master::slave::SlaveReturn<bool> slaveReturn = readCoils<bool>(0, 1);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read single Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read single Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -102,14 +102,14 @@ bool SingleSlaveExampleDevice::readExampleSingleCoil() {
 void SingleSlaveExampleDevice::writeExampleSingleCoil(bool state) {
     dynamic_modbus_master::ModbusError error = writeCoils(0, state, 1);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write single Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write single Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 bool SingleSlaveExampleDevice::readDiscreteInput() {
     dynamic_modbus_master::slave::SlaveReturn<bool> slaveReturn = readDiscreteInputs<bool>(0);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Discrete Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Discrete Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -117,7 +117,7 @@ bool SingleSlaveExampleDevice::readDiscreteInput() {
 uint16_t SingleSlaveExampleDevice::readInput() {
     dynamic_modbus_master::slave::SlaveReturn<uint16_t> slaveReturn = readInputs<uint16_t>(0);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
     return slaveReturn.data;
@@ -30,7 +30,7 @@ uint16_t AggregateDevice::readExampleSingleRegister() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -40,7 +40,7 @@ uint32_t AggregateDevice::readExampleMultipleRegisters() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -50,7 +50,7 @@ float AggregateDevice::readExampleFloat() {
     if (slaveReturn.error == dynamic_modbus_master::ModbusError::OK) {
         return slaveReturn.data;
     } else {
-        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("Single Slave Example Device", "Error Occured : %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
 }
@@ -58,28 +58,28 @@ float AggregateDevice::readExampleFloat() {
 void AggregateDevice::writeExampleSingleRegister(uint16_t data) {
     dynamic_modbus_master::ModbusError error = m_device.writeHolding(1, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 void AggregateDevice::writeExampleMultipleRegisters(uint32_t data) {
     dynamic_modbus_master::ModbusError error = m_device.writeHolding(2, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 void AggregateDevice::writeExampleFloat(float data) {
     dynamic_modbus_master::ModbusError error = m_device.writeHolding(4, data);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Data %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 bool AggregateDevice::readExampleSingleCoil() {
     dynamic_modbus_master::slave::SlaveReturn<bool> slaveReturn = m_device.readCoils<bool>(0, 1);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -87,14 +87,14 @@ bool AggregateDevice::readExampleSingleCoil() {
 void AggregateDevice::writeExampleSingleCoil(bool state) {
     dynamic_modbus_master::ModbusError error = m_device.writeCoils(0, state, 1);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 uint16_t AggregateDevice::readExampleMultipleCoils() {
     dynamic_modbus_master::slave::SlaveReturn<uint16_t> slaveReturn = m_device.readCoils<uint16_t>(1, 16);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Coils %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -102,14 +102,14 @@ uint16_t AggregateDevice::readExampleMultipleCoils() {
 void AggregateDevice::writeExampleMultipleCoils(uint16_t coilStates) {
     dynamic_modbus_master::ModbusError error = m_device.writeCoils(1, coilStates, 16);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to write Coil %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
     }
 }
 
 bool AggregateDevice::readDiscreteInput() {
     dynamic_modbus_master::slave::SlaveReturn<bool> slaveReturn = m_device.readDiscreteInputs<bool>(0);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Discrete Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Discrete Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
     }
     return slaveReturn.data;
 }
@@ -117,7 +117,7 @@ bool AggregateDevice::readDiscreteInput() {
 uint16_t AggregateDevice::readInput() {
     dynamic_modbus_master::slave::SlaveReturn<uint16_t> slaveReturn = m_device.readInputs<uint16_t>(0);
     if (slaveReturn.error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).c_str());
+        ESP_LOGE("SingleSlaveExampleDevice", "Failed to read Input %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(slaveReturn.error).data());
         return -1;
     }
     return slaveReturn.data;
@@ -25,13 +25,13 @@ AggregateDevice g_exampleDevice(1, 1, master);
 extern "C" void app_main(void) {
     dynamic_modbus_master::ModbusError error = master.initialise(config);
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("app_main", "Modbus initialization failed: %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("app_main", "Modbus initialization failed: %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
         return;
     }
     
     error = master.start();
     if (error != dynamic_modbus_master::ModbusError::OK) {
-        ESP_LOGE("app_main", "Modbus start failed: %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).c_str());
+        ESP_LOGE("app_main", "Modbus start failed: %s", dynamic_modbus_master::ModbusErrorHelper::modbusErrorToName(error).data());
         return;
     }
     
@@ -0,0 +1,307 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_BUSEXECUTOR_H
+#define DYNAMIC_MODBUS_MASTER_BUSEXECUTOR_H
+
+#include "DynamicModbusMaster.h"
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "WordOrder.hpp"
+#include "RequestQueue.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+
+namespace dynamic_modbus_master::coro {
+
+class BusExecutor;
+
+template<typename R>
+class RequestAwaitable;
+
+/**
+ * @brief Coroutine type for sequences of requests that are driven by a dynamic_modbus_master::coro::BusExecutor.
+ *
+ * @details A BusTask does not start until it is passed to BusExecutor::spawn, after that the executor owns the
+ * coroutine and destroys it once it completes.
+ *
+ * @warning Arguments of the coroutine that are references, including the captures of a lambda coroutine, must outlive
+ * the coroutine.
+ */
+class BusTask {
+public:
+    struct promise_type {
+        BusExecutor* executor = nullptr;
+        
+        BusTask get_return_object() {
+            return BusTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        
+        void return_void();
+        
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+    
+    BusTask(BusTask&& other) noexcept: m_handle(other.m_handle) {
+        other.m_handle = nullptr;
+    }
+    
+    BusTask(const BusTask&) = delete;
+    
+    BusTask& operator=(const BusTask&) = delete;
+    
+    ~BusTask() {
+        // Only tasks that were never spawned are still owned here
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+private:
+    friend class BusExecutor;
+    
+    explicit BusTask(std::coroutine_handle<promise_type> handle): m_handle(handle) {
+    }
+    
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief Event-driven executor resuming the coroutines of a single application task once their requests complete.
+ *
+ * @details Requests awaited by a BusTask are executed by the bus task of the master, see
+ * dynamic_modbus_master::RequestQueue. When a request completes, its coroutine is marked ready and resumed by the task
+ * calling `run` or `runOnce`. This allows a single task to drive sequences across many devices, the only memory
+ * necessary per sequence is its coroutine frame. With `CONFIG_DMM_STATIC_POOLS` the ready list is reserved inside the
+ * executor for `CONFIG_DMM_EXECUTOR_TASKS` tasks.
+ *
+ * @code{.cpp}
+ * BusTask pollMeter(AwaitableDevice<SlaveDevice>& meter) {
+ *     while (true) {
+ *         SlaveReturn<float> power = co_await meter.readHolding<float>(4);
+ *         co_await meter.writeHolding<uint16_t>(1, 0);
+ *     }
+ * }
+ *
+ * BusExecutor executor;
+ * executor.spawn(pollMeter(meterA));
+ * executor.spawn(pollMeter(meterB));
+ * executor.run();
+ * @endcode
+ */
+class BusExecutor {
+public:
+    BusExecutor();
+    
+    ~BusExecutor();
+    
+    /**
+     * @brief Take ownership of a task and schedule it for its first resumption.
+     *
+     * @param task The task to start.
+     * @return ModbusError::OK if the task was scheduled, ModbusError::QUEUE_FULL if `CONFIG_DMM_EXECUTOR_TASKS` tasks
+     * are already active with static pools, in which case the task is destroyed.
+     */
+    ModbusError spawn(BusTask task);
+    
+    /**
+     * @brief Resume ready coroutines until all spawned tasks have completed.
+     */
+    void run();
+    
+    /**
+     * @brief Resume a single ready coroutine.
+     *
+     * @param wait The maximum number of ticks to wait for a coroutine to become ready.
+     * @return true if a coroutine was resumed, false if none became ready in time.
+     */
+    bool runOnce(TickType_t wait = portMAX_DELAY);
+    
+    /**
+     * @brief Get the number of spawned tasks that have not yet completed.
+     *
+     * @return The number of active tasks.
+     */
+    size_t active() const;
+
+private:
+    friend struct BusTask::promise_type;
+    template<typename R>
+    friend class RequestAwaitable;
+    
+    /**
+     * @brief Mark a suspended coroutine as ready, may be called from any task.
+     *
+     * @details Only called for spawned tasks that are suspended, so every task is ready at most once.
+     *
+     * @param handle The coroutine to resume.
+     */
+    void schedule(std::coroutine_handle<> handle);
+    
+    std::mutex m_mutex;
+#if CONFIG_DMM_STATIC_POOLS
+    // Every active task is ready at most once, so the ring cannot overflow as long as spawn limits the active tasks
+    std::array<std::coroutine_handle<>, CONFIG_DMM_EXECUTOR_TASKS> m_ready;
+    size_t m_readyFirst = 0;
+    size_t m_readyCount = 0;
+    StaticSemaphore_t m_readySignalBuffer;
+#else
+    std::deque<std::coroutine_handle<>> m_ready;
+#endif
+    SemaphoreHandle_t m_readySignal;
+    std::atomic<size_t> m_active = 0;
+};
+
+/**
+ * @brief Awaitable executing a single blocking operation on the bus task of a master.
+ *
+ * @details Suspends the awaiting BusTask until the operation has completed. If the request cannot be queued, the
+ * coroutine is not suspended and the error of the queue is returned as the result instead.
+ *
+ * @tparam R The result of the operation, either ModbusError or a SlaveReturn.
+ */
+template<typename R>
+class RequestAwaitable {
+public:
+#if CONFIG_DMM_STATIC_POOLS
+    using Operation = InplaceFunction<R(), CONFIG_DMM_ASYNC_REQUEST_SIZE>;
+#else
+    using Operation = std::function<R()>;
+#endif
+    
+    RequestAwaitable(RequestQueue* requestQueue, Operation operation):
+            m_requestQueue(requestQueue), m_operation(std::move(operation)) {
+    }
+    
+    bool await_ready() const noexcept {
+        return false;
+    }
+    
+    bool await_suspend(std::coroutine_handle<BusTask::promise_type> handle) {
+        ModbusError error = ModbusError::INVALID_STATE;
+        BusExecutor* executor = handle.promise().executor;
+        if (m_requestQueue && executor) {
+            error = m_requestQueue->enqueue([this, handle, executor] {
+                m_result = m_operation();
+                executor->schedule(handle);
+            });
+        }
+        if (error == ModbusError::OK) {
+            return true;
+        }
+        if constexpr (std::is_same_v<R, ModbusError>) {
+            m_result = error;
+        } else {
+            m_result.error = error;
+        }
+        return false;
+    }
+    
+    R await_resume() {
+        return m_result;
+    }
+
+private:
+    RequestQueue* m_requestQueue;
+    Operation m_operation;
+    R m_result{};
+};
+
+/**
+ * @brief Awaitable view of a slave device, every operation returns a RequestAwaitable.
+ *
+ * @details The operations mirror dynamic_modbus_master::slave::SlaveDeviceIfc and are forwarded to the blocking
+ * operations of the device, which are executed on the bus task of the master. This works for any implementation of
+ * the interface. The request queue of the master must be running, see DynamicModbusMaster::startRequestQueue.
+ *
+ * @tparam Device The device implementation, derived from dynamic_modbus_master::slave::SlaveDeviceIfc.
+ */
+template<class Device>
+class AwaitableDevice {
+public:
+    /**
+     * @brief Creates an awaitable view of a device.
+     *
+     * @param device The device to forward operations to, must outlive the view.
+     * @param master The master whose request queue executes the operations.
+     */
+    AwaitableDevice(Device& device, const DynamicModbusMaster& master): m_device(device), m_master(master) {
+    }
+    
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
+    RequestAwaitable<ModbusError> writeHolding(uint16_t reg, D data) {
+        return {m_master.getRequestQueue(), [this, reg, data] {
+            return m_device.template writeHolding<D, Order>(reg, data);
+        }};
+    }
+    
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
+    RequestAwaitable<slave::SlaveReturn<D>> readHolding(uint16_t reg) {
+        return {m_master.getRequestQueue(), [this, reg] { return m_device.template readHolding<D, Order>(reg); }};
+    }
+    
+    template<ModbusData D>
+    RequestAwaitable<ModbusError> writeCoils(uint16_t reg, D data, uint16_t coilNum) {
+        return {m_master.getRequestQueue(), [this, reg, data, coilNum] {
+            return m_device.template writeCoils<D>(reg, data, coilNum);
+        }};
+    }
+    
+    template<ModbusData D>
+    RequestAwaitable<slave::SlaveReturn<D>> readCoils(uint16_t reg, uint16_t coilNum) {
+        return {m_master.getRequestQueue(), [this, reg, coilNum] { return m_device.template readCoils<D>(reg, coilNum); }};
+    }
+    
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
+    RequestAwaitable<slave::SlaveReturn<D>> readInputs(uint16_t reg) {
+        return {m_master.getRequestQueue(), [this, reg] { return m_device.template readInputs<D, Order>(reg); }};
+    }
+    
+    template<ModbusData D>
+    RequestAwaitable<slave::SlaveReturn<D>> readDiscreteInputs(uint16_t reg) {
+        return {m_master.getRequestQueue(), [this, reg] { return m_device.template readDiscreteInputs<D>(reg); }};
+    }
+
+private:
+    Device& m_device;
+    const DynamicModbusMaster& m_master;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_BUSEXECUTOR_H
@@ -0,0 +1,212 @@
+// Copyright (c) 2024 Dominik M. Glogowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_CACHEDSLAVEDEVICE_HPP
+#define DYNAMIC_MODBUS_MASTER_CACHEDSLAVEDEVICE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include "ModbusData.hpp"
+#include "ModbusRequest.h"
+#include "RegisterCache.h"
+#include "SlaveDeviceIfc.h"
+#include "WordOrder.hpp"
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @brief Decorator serving reads of a device from a dynamic_modbus_master::slave::RegisterCache.
+ *
+ * @details Reads are answered from the cache while all registers of the read are cached and not expired, otherwise
+ * they are forwarded to the device and the result is stored in the cache. Writes are always forwarded and remove the
+ * written registers or coils from the cache, so the next read returns the value of the device.
+ *
+ * @code{.cpp}
+ * SlaveDevice device(1, 2, master);
+ * CachedSlaveDevice cached(device, std::chrono::milliseconds(100));
+ * cached.getCache().setTtl(RegisterType::INPUT, 10, 2, std::chrono::seconds(5));
+ *
+ * SlaveReturn<float> temperature = cached.readInputs<float>(10);   // Request
+ * temperature = cached.readInputs<float>(10);                      // Served from the cache for 5s
+ * @endcode
+ *
+ * The cache holds the registers as received, reads with a word order are converted after the lookup.
+ *
+ * @tparam Device The device implementation that is decorated, derived from dynamic_modbus_master::slave::SlaveDeviceIfc.
+ */
+template<class Device>
+class CachedSlaveDevice : public SlaveDeviceIfc<CachedSlaveDevice<Device>> {
+public:
+    /**
+     * @brief Creates a cache for a device.
+     *
+     * @param device The device, must outlive the decorator.
+     * @param defaultTtl The time to live of all registers without a specific time to live, see RegisterCache::setTtl.
+     */
+    CachedSlaveDevice(Device& device, std::chrono::milliseconds defaultTtl): m_device(device), m_cache(defaultTtl) {
+    }
+    
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    ModbusError writeHolding(uint16_t reg, T data) const {
+        ModbusError error = m_device.template writeHolding<T, Order>(reg, data);
+        m_cache.invalidate(RegisterType::HOLDING, reg, registerCount<T>());
+        return error;
+    }
+    
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    SlaveReturn<T> readHolding(uint16_t reg) const {
+        return readRegisters<T, Order>(RegisterType::HOLDING, reg, [this, reg] {
+            return m_device.template readHolding<T>(reg);
+        });
+    }
+    
+    template<ModbusData W, ModbusData R>
+    SlaveReturn<R> writeReadHolding(uint16_t writeReg, W data, uint16_t readReg) const {
+        // The read has to observe the write, it is never served from the cache
+        SlaveReturn<R> result = m_device.template writeReadHolding<W, R>(writeReg, data, readReg);
+        m_cache.invalidate(RegisterType::HOLDING, writeReg, registerCount<W>());
+        if (result.error == ModbusError::OK) {
+            uint16_t values[registerCount<R>()]{};
+            std::memcpy(values, &result.data, std::min(sizeof(R), sizeof(values)));
+            m_cache.store(RegisterType::HOLDING, readReg, registerCount<R>(), values);
+        }
+        return result;
+    }
+    
+    template<ModbusData T>
+    ModbusError writeCoils(uint16_t reg, T data, uint16_t coilNum) const {
+        ModbusError error = m_device.template writeCoils<T>(reg, data, coilNum);
+        m_cache.invalidate(RegisterType::COIL, reg, coilNum);
+        return error;
+    }
+    
+    template<ModbusData T>
+    SlaveReturn<T> readCoils(uint16_t reg, uint16_t coilNum) const {
+        return readBits<T>(RegisterType::COIL, reg, coilNum, [this, reg, coilNum] {
+            return m_device.template readCoils<T>(reg, coilNum);
+        });
+    }
+    
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    SlaveReturn<T> readInputs(uint16_t reg) const {
+        return readRegisters<T, Order>(RegisterType::INPUT, reg, [this, reg] {
+            return m_device.template readInputs<T>(reg);
+        });
+    }
+    
+    template<ModbusData T>
+    SlaveReturn<T> readDiscreteInputs(uint16_t reg) const {
+        constexpr uint16_t bitCount = (std::is_same_v<T, bool> ? 1 : sizeof(T) * 8);
+        return readBits<T>(RegisterType::DISCRETE_INPUT, reg, bitCount, [this, reg] {
+            return m_device.template readDiscreteInputs<T>(reg);
+        });
+    }
+    
+    /**
+     * @brief Get the decorated device.
+     *
+     * @return The device.
+     */
+    Device& getDevice() const {
+        return m_device;
+    }
+    
+    /**
+     * @brief Get the cache, to configure time to live values, invalidate registers or query its statistics.
+     *
+     * @return The cache.
+     */
+    RegisterCache& getCache() const {
+        return m_cache;
+    }
+
+private:
+    Device& m_device;
+    mutable RegisterCache m_cache;
+    
+    template<ModbusData T>
+    static constexpr uint16_t registerCount() {
+        return std::max<uint16_t>(1, sizeof(T) / sizeof(uint16_t));
+    }
+    
+    template<ModbusData T, WordOrder Order, typename Read>
+    SlaveReturn<T> readRegisters(RegisterType type, uint16_t reg, Read read) const {
+        constexpr uint16_t count = registerCount<T>();
+        constexpr size_t size = std::min(sizeof(T), count * sizeof(uint16_t));
+        uint16_t values[count]{};
+        
+        SlaveReturn<T> result{ModbusError::OK, T{}};
+        if (m_cache.lookup(type, reg, count, values)) {
+            std::memcpy(&result.data, values, size);
+        } else {
+            result = read();
+            if (result.error == ModbusError::OK) {
+                std::memcpy(values, &result.data, size);
+                m_cache.store(type, reg, count, values);
+            }
+        }
+        if constexpr (Order != WordOrder::CDAB && sizeof(T) % sizeof(uint16_t) == 0) {
+            convertRegisters<T, Order>(&result.data, &result.data, 1);
+        }
+        return result;
+    }
+    
+    template<ModbusData T, typename Read>
+    SlaveReturn<T> readBits(RegisterType type, uint16_t reg, uint16_t bitCount, Read read) const {
+        constexpr bool single = std::is_same_v<T, bool>;
+        constexpr uint16_t capacity = (single ? 1 : sizeof(T) * 8);
+        if (bitCount == 0 || bitCount > capacity) {
+            // Not representable by T, the device decides how to handle the request
+            return read();
+        }
+        uint16_t values[capacity]{};
+        
+        SlaveReturn<T> result{ModbusError::OK, T{}};
+        if (m_cache.lookup(type, reg, bitCount, values)) {
+            if constexpr (single) {
+                result.data = values[0] != 0;
+            } else {
+                auto* bytes = reinterpret_cast<uint8_t*>(&result.data);
+                for (uint16_t i = 0; i < bitCount; i++) {
+                    bytes[i / 8] |= static_cast<uint8_t>(values[i] << (i % 8));
+                }
+            }
+            return result;
+        }
+        result = read();
+        if (result.error == ModbusError::OK) {
+            if constexpr (single) {
+                values[0] = result.data;
+            } else {
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&result.data);
+                for (uint16_t i = 0; i < bitCount; i++) {
+                    values[i] = (bytes[i / 8] >> (i % 8)) & 1;
+                }
+            }
+            m_cache.store(type, reg, bitCount, values);
+        }
+        return result;
+    }
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_CACHEDSLAVEDEVICE_HPP
@@ -0,0 +1,233 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_CHANGEMONITOR_H
+#define DYNAMIC_MODBUS_MASTER_CHANGEMONITOR_H
+
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include "SlaveDevice.h"
+#include "WordOrder.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @struct ChangeStatistics
+ * @brief Effectiveness of a dynamic_modbus_master::slave::ChangeMonitor.
+ *
+ * @param polls The number of times the subscriptions were polled.
+ * @param unchangedBlocks The number of successfully read requests whose registers were identical to the previous read,
+ * no subscription was evaluated for them.
+ * @param notifications The number of callbacks that were invoked.
+ * @param suppressed The number of changes that were not notified since they were within the deadband.
+ * @param failures The number of requests that failed, the subscriptions they serve were not evaluated.
+ */
+struct ChangeStatistics {
+    uint32_t polls;
+    uint32_t unchangedBlocks;
+    uint32_t notifications;
+    uint32_t suppressed;
+    uint32_t failures;
+};
+
+/**
+ * @brief Subscriptions to the holding and input registers of a single slave device, notified only on changes.
+ *
+ * @details Subscribed points and blocks are read with as few requests as possible, merged the same way as by
+ * dynamic_modbus_master::slave::ReadPlan. Each response is compared with the previous response 64 bits at a time,
+ * subscriptions are only evaluated if one of their registers changed. A point subscription is notified when its value
+ * differs from the last notified value by more than its deadband, a block subscription for every run of registers
+ * that differ from the last notified registers. Every subscription is notified with its initial value after the first
+ * successful read.
+ *
+ * `poll` is typically called periodically, for example as a job of a dynamic_modbus_master::ScanScheduler, callbacks
+ * are invoked by the task calling `poll`.
+ *
+ * @code{.cpp}
+ * ChangeMonitor monitor(device);
+ * monitor.subscribe<float, WordOrder::ABCD>(RegisterType::INPUT, 0, [](float temperature) {
+ *     publish("temperature", temperature);
+ * }, 0.5f);
+ * monitor.subscribeBlock(RegisterType::HOLDING, 100, 50, [](uint16_t reg, std::span<const uint16_t> values) {
+ *     publish(reg, values);
+ * });
+ * scheduler.addJob(std::chrono::seconds(1), [&] { return monitor.poll(); });
+ * @endcode
+ *
+ * Coils and discrete inputs are compared with dynamic_modbus_master::PackedBits::changed instead.
+ *
+ * @warning Callbacks must not subscribe or unsubscribe, the monitor is locked while they are invoked.
+ */
+class ChangeMonitor {
+public:
+    /**
+     * @brief Returned by `subscribe` and `subscribeBlock` if the subscription is invalid.
+     */
+    static constexpr size_t INVALID_ID = SIZE_MAX;
+    
+    /**
+     * @brief Callback of a block subscription, invoked with the first register and the values of a run of changed
+     * registers.
+     */
+    using BlockCallback = std::function<void(uint16_t reg, std::span<const uint16_t> values)>;
+    
+    /**
+     * @brief Creates a monitor without subscriptions.
+     *
+     * @param device The device that is read, must outlive the monitor.
+     * @param maxGap The maximum number of unused registers between two subscriptions that are still read with a single
+     * request. The unused registers are read and discarded, so they must be readable on the device.
+     */
+    explicit ChangeMonitor(const SlaveDevice& device, uint16_t maxGap = 0);
+    
+    /**
+     * @brief Subscribe to a point.
+     *
+     * @tparam T The type of the point. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device transmits the point in.
+     * @param type The register type of the point, RegisterType::HOLDING or RegisterType::INPUT.
+     * @param reg The first register of the point.
+     * @param callback Invoked with the new value of the point.
+     * @param deadband Changes of arithmetic types by no more than this amount are not notified. All other changes are
+     * notified.
+     * @return The id of the subscription, INVALID_ID if the register type is not a register or the point exceeds the
+     * address range.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB> requires (sizeof(T) % sizeof(uint16_t) == 0)
+    size_t subscribe(RegisterType type, uint16_t reg, std::function<void(T)> callback, T deadband = T{}) {
+        static_assert(sizeof(T) / sizeof(uint16_t) <= MAX_READ_REGISTERS, "Points must fit into a single request");
+        return add(type, reg, sizeof(T) / sizeof(uint16_t),
+                   [callback = std::move(callback), deadband](const uint16_t* registers, const uint16_t* last,
+                                                              bool initial, ChangeStatistics& statistics) {
+            if (!initial && std::memcmp(registers, last, sizeof(T)) == 0) {
+                return false;
+            }
+            T value;
+            convertRegisters<T, Order>(registers, &value, 1);
+            if constexpr (std::is_arithmetic_v<T>) {
+                T previous;
+                convertRegisters<T, Order>(last, &previous, 1);
+                // Integers are compared as unsigned 64-Bit values, the difference of signed values cannot overflow
+                using Wide = std::conditional_t<std::is_floating_point_v<T>, double, uint64_t>;
+                Wide difference = (value > previous ? static_cast<Wide>(value) - static_cast<Wide>(previous)
+                                                    : static_cast<Wide>(previous) - static_cast<Wide>(value));
+                if (!initial && difference <= static_cast<Wide>(deadband)) {
+                    statistics.suppressed++;
+                    return false;
+                }
+            }
+            callback(value);
+            statistics.notifications++;
+            return true;
+        });
+    }
+    
+    /**
+     * @brief Subscribe to a block of registers.
+     *
+     * @param type The register type of the block, RegisterType::HOLDING or RegisterType::INPUT.
+     * @param reg The first register of the block.
+     * @param size The number of registers, at most MAX_READ_REGISTERS.
+     * @param callback Invoked once for every run of changed registers.
+     * @return The id of the subscription, INVALID_ID if the register type is not a register, the block is empty,
+     * larger than MAX_READ_REGISTERS or exceeds the address range.
+     */
+    size_t subscribeBlock(RegisterType type, uint16_t reg, uint16_t size, BlockCallback callback);
+    
+    /**
+     * @brief Remove a subscription, it is not notified again.
+     *
+     * @param id The id of the subscription.
+     * @return ModbusError::OK if the subscription was removed, ModbusError::INVALID_ARG if no subscription with this
+     * id exists.
+     */
+    ModbusError unsubscribe(size_t id);
+    
+    /**
+     * @brief Read all subscribed registers and notify the subscriptions that changed.
+     *
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request. The
+     * subscriptions served by failed requests are evaluated by the next successful read.
+     */
+    ModbusError poll();
+    
+    /**
+     * @brief Get the statistics of the monitor.
+     *
+     * @return The statistics since the monitor was created.
+     */
+    ChangeStatistics getStatistics() const;
+
+private:
+    /**
+     * @brief Decides whether a subscription is notified and invokes its callback.
+     *
+     * @details Invoked with the registers of the subscription as received, the registers of the last notification and
+     * whether this is the first notification. Returns whether the subscription was notified.
+     */
+    using Notify = std::function<bool(const uint16_t* registers, const uint16_t* last, bool initial,
+                                      ChangeStatistics& statistics)>;
+    
+    struct Subscription {
+        size_t id;
+        RegisterType type;
+        uint16_t reg;
+        uint16_t size;
+        Notify notify;
+        std::vector<uint16_t> last;
+        bool notified;
+    };
+    
+    struct Block {
+        RegisterType type;
+        uint16_t regStart;
+        uint16_t regSize;
+        std::vector<size_t> subscriptions;
+        std::vector<uint16_t> current;
+        std::vector<uint16_t> previous;
+        bool valid;
+    };
+    
+    const SlaveDevice& m_device;
+    uint16_t m_maxGap;
+    mutable std::mutex m_mutex;
+    std::vector<Subscription> m_subscriptions;
+    std::vector<Block> m_blocks;
+    bool m_planned = false;
+    size_t m_nextId = 0;
+    ChangeStatistics m_statistics{};
+    
+    size_t add(RegisterType type, uint16_t reg, uint16_t size, Notify notify);
+    
+    void plan();
+    
+    void evaluate(Block& block);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_CHANGEMONITOR_H
@@ -0,0 +1,129 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_DEVICEHEALTH_H
+#define DYNAMIC_MODBUS_MASTER_DEVICEHEALTH_H
+
+#include "ModbusError.h"
+#include <sdkconfig.h>
+#include <chrono>
+#include <cinttypes>
+#include <mutex>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @brief Health of a slave device, as judged by its recent requests.
+ */
+enum class HealthState : uint8_t {
+    HEALTHY,        //!< The device answered its last request, requests are retried as configured
+    SUSPECT,        //!< The device left its last request unanswered, requests are not retried
+    QUARANTINED,    //!< The device left several requests unanswered, requests fail except for periodic probes
+};
+
+/**
+ * @brief Circuit breaker keeping unresponsive slave devices from occupying the bus.
+ *
+ * @details A device becomes suspect once it leaves a request unanswered and quarantined after
+ * `quarantineThreshold` consecutive unanswered requests. While quarantined, `admit` only lets a single probe request
+ * pass once the probe interval has passed, the interval doubles after every unanswered probe up to the maximum. Any
+ * answer, including exceptions, restores the device to healthy.
+ *
+ * The health is safe to be used from several tasks. Copies start with the state of the original.
+ */
+class DeviceHealth {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Creates a healthy device health.
+     *
+     * @param quarantineThreshold The number of consecutive unanswered requests until the device is quarantined.
+     * @param probeInterval The time until the first probe of a quarantined device.
+     * @param maxProbeInterval The upper bound of the time between two probes.
+     */
+    explicit DeviceHealth(uint8_t quarantineThreshold = CONFIG_DMM_QUARANTINE_THRESHOLD,
+                          std::chrono::milliseconds probeInterval = std::chrono::milliseconds(CONFIG_DMM_PROBE_INTERVAL_MS),
+                          std::chrono::milliseconds maxProbeInterval =
+                                  std::chrono::milliseconds(CONFIG_DMM_PROBE_INTERVAL_MAX_MS));
+    
+    DeviceHealth(const DeviceHealth& other);
+    
+    DeviceHealth& operator=(const DeviceHealth& other);
+    
+    /**
+     * @brief Decide whether a request may be sent to the device.
+     *
+     * @param now The current time.
+     * @return true if the device is not quarantined or the request is sent as probe, false if the request must fail
+     * with ModbusError::DEVICE_QUARANTINED.
+     */
+    bool admit(Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Record the result of a request that was admitted.
+     *
+     * @details Responses, including exceptions, restore the device to healthy. ModbusError::TIMEOUT,
+     * ModbusError::INVALID_RESPONSE, ModbusError::FAILURE and ModbusError::GATEWAY_TARGET_NO_RESPONSE count as
+     * unanswered. Other errors do not affect the health, a probe that ended with one of them is repeated.
+     *
+     * @param result The result of the request after all of its retries.
+     * @param now The current time.
+     */
+    void record(ModbusError result, Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Restore the device to healthy, for example after it was replaced.
+     */
+    void reset();
+    
+    /**
+     * @brief Get the current state.
+     *
+     * @return The health state of the device.
+     */
+    HealthState state() const;
+    
+    /**
+     * @brief Get the time from which the next probe of a quarantined device is admitted.
+     *
+     * @return The time of the next probe, only meaningful while the device is quarantined.
+     */
+    Clock::time_point nextProbe() const;
+
+private:
+    uint8_t m_quarantineThreshold;
+    Clock::duration m_probeInterval;
+    Clock::duration m_maxProbeInterval;
+    
+    mutable std::mutex m_mutex;
+    HealthState m_state = HealthState::HEALTHY;
+    uint8_t m_timeouts = 0;
+    bool m_probing = false;
+    Clock::duration m_currentInterval;
+    Clock::time_point m_nextProbe{};
+    
+    void recordResponse();
+    
+    void recordUnanswered(Clock::time_point now);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_DEVICEHEALTH_H
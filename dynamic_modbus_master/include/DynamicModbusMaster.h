@@ -22,27 +22,67 @@
 #define DYNAMIC_MODBUS_MASTER_DYNAMICMODBUSMASTER_H
 
 #include "ModbusError.h"
+#include "ModbusTransport.h"
+#include "RequestError.h"
+#include "RequestMetrics.h"
+#include "RequestQueue.h"
+#include <memory>
+#include <optional>
+#include <sdkconfig.h>
+
+#if !CONFIG_IDF_TARGET_LINUX
 #include "ModbusConfiguration.h"
+#endif
 
 namespace dynamic_modbus_master {
+/**
+ * @struct MemoryFootprint
+ * @brief RAM occupied by a dynamic_modbus_master::DynamicModbusMaster, the bus it drives and the devices on it.
+ *
+ * @details All sizes are in bytes. The RAM of a bus is `master + transport + requestQueue`, every slave device
+ * attached to it adds `device`.
+ *
+ * @param master The master itself, without its request queue.
+ * @param transport The transport including its buffers and tasks, see transport::ModbusTransport::memoryFootprint.
+ * @param requestQueue The request queue including its entries and the stack of the bus task. With
+ * `CONFIG_DMM_STATIC_POOLS` it is part of the master and always reserved, otherwise it is 0 while the queue is stopped.
+ * @param device The size of a dynamic_modbus_master::slave::SlaveDevice.
+ */
+struct MemoryFootprint {
+    size_t master;
+    size_t transport;
+    size_t requestQueue;
+    size_t device;
+};
+
 /**
  * @brief Modbus Master Controller
  *
- * @brief Dynamic Modbus Master Class to manage the initialisation, starting and destroying of the underlying
- * esp_modbus library.
+ * @brief Dynamic Modbus Master Class to manage the initialisation, starting and destroying of the transport that
+ * carries the requests of all slave devices attached to this master. By default this is esp-modbus serial
+ * communication, alternatively any dynamic_modbus_master::transport::ModbusTransport can be provided.
  */
 class DynamicModbusMaster {
 public:
     /**
-     * @brief Destroys the previously with `initialise` allocated Modbus Master controller.
+     * @brief Handler invoked with every request of an attached device that failed, with `CONFIG_DMM_STATIC_POOLS` it
+     * may capture up to `CONFIG_DMM_CALLBACK_SIZE` bytes.
+     */
+    using ErrorHandler = RequestCallback<void(const RequestError& error)>;
+    
+    /**
+     * @brief Destroys the previously with `initialise` allocated transport.
      */
     ~DynamicModbusMaster();
 
+#if !CONFIG_IDF_TARGET_LINUX
     /**
      * @brief Initialize the Modbus Master controller and set up the communication parameters.
      *
-     * @details This function initializes the Modbus Master controller and sets up the communication
-     * parameters for the Modbus connection.
+     * @details This function initializes the Modbus Master controller with a
+     * dynamic_modbus_master::transport::SerialTransport and sets up the communication
+     * parameters for the Modbus connection. If `CONFIG_DMM_NATIVE_RTU` is enabled, RTU connections use a
+     * dynamic_modbus_master::transport::RtuTransport instead.
      *
      * @param config The configuration of the Modbus connection.
      * @return An instance of ModbusError representing the result of the initialization.<br>
@@ -50,27 +90,43 @@ public:
      * <ul>
      * <li> ModbusError::OK - Initalisation was successful
      * <li> ModbusError::PORT_NOT_SUPPORTED - The MB Port Type was not supported
-     * <li> ModbusError::INVALID_STATE - Inialisation failure
+     * <li> ModbusError::INVALID_STATE - Inialisation failure or the request queue is running
      * <li> ModbusError::INVALID_ARG - Invalid Argument
      * <li> ModbusError::FAILURE_OR_EXCEPTION - Undetermined Failure
      * </ul>
      */
     ModbusError initialise(ModbusConfig config);
+#endif
+    
+    /**
+     * @brief Initialize the Modbus Master controller with a custom transport.
+     *
+     * @details The master takes ownership of the transport, any previously initialised transport is destroyed. The
+     * transport cannot be replaced while the request queue is running, as the bus task might be sending a request
+     * through the previous transport.
+     *
+     * @param transport The transport all requests of this master are sent through.
+     * @return An instance of ModbusError representing the result of the initialization.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - Initalisation was successful
+     * <li> ModbusError::INVALID_ARG - The transport was a `nullptr`
+     * <li> ModbusError::INVALID_STATE - The request queue is running
+     * </ul>
+     */
+    ModbusError initialise(std::unique_ptr<transport::ModbusTransport> transport);
     
     /**
      * @brief Start the Modbus communication stack.
      *
-     * @details This function starts the Modbus communication stack by calling the `mbc_master_start()` function.
-     * If an error occurs during the start process, an error log is generated using the `ESP_LOGE` macro with the tag
-     * "DynamicModbusMaster" and the error name is printed using the `esp_err_to_name()` function. The function returns
-     * `ModbusError::INVALID_ARG` to indicate an invalid argument error. If the start process is successful, the
-     * function returns `ModbusError::OK`.
+     * @details This function starts the transport that was created during initialisation.
      *
      * @return An instance of ModbusError representing the result of the start process.<br>
      * Possible Results:
      * <ul>
      * <li> ModbusError::OK - Start process was successful
      * <li> ModbusError::INVALID_ARG - Invalid argument error
+     * <li> ModbusError::INVALID_STATE - The master was never initialised
      * </ul>
      */
     ModbusError start();
@@ -78,11 +134,7 @@ public:
     /**
      * @brief Stop the Modbus communication stack.
      *
-     * @details This function stops the Modbus communication stack by calling the `mbc_master_stop()` function.
-     * If an error occurs during the stop process, an error log is generated using the `ESP_LOGE` macro with the tag
-     * "DynamicModbusMaster" and the error name is printed using the `esp_err_to_name()` function. The function returns
-     * `ModbusError::INVALID_STATE` to indicate an invalid state error. If the stop process is successful, the
-     * function returns `ModbusError::OK`.
+     * @details This function stops the transport that was created during initialisation.
      *
      * @return An instance of ModbusError representing the result of the stop process. <br>
      * Possible Results:
@@ -99,12 +151,104 @@ public:
      * @note Creating multiple instances was a feature introduced in esp modbus version 2.0, previous version allowed only for one global master to exist even with different protocols.
      * 
      * @return Non owning pointer to the context handle, that allows to refer to the initally created Modbus communication stack.
+     * `nullptr` if the master does not use esp-modbus serial communication.
      */
     void* getContext() const;
+    
+    /**
+     * @brief Get the transport all requests of this master are sent through.
+     *
+     * @return Non owning pointer to the transport, `nullptr` if the master was not initialised.
+     */
+    transport::ModbusTransport* getTransport() const;
+    
+    /**
+     * @brief Start the request queue and the bus task servicing it, required for asynchronous requests.
+     *
+     * @param length The maximum number of pending requests per priority class.
+     * @param priority The FreeRTOS priority of the bus task.
+     * @param stackSize The stack size of the bus task in bytes.
+     * @param core The core the bus task is pinned to, `tskNO_AFFINITY` to run it on any core.
+     * @return An instance of ModbusError representing the result of the start process.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - The request queue was started
+     * <li> ModbusError::INVALID_STATE - The master was not initialised or the request queue is already running
+     * <li> ModbusError::INVALID_ARG - With `CONFIG_DMM_STATIC_POOLS` the length or stack size exceed the reserved
+     * `CONFIG_DMM_REQUEST_QUEUE_LENGTH` or `CONFIG_DMM_BUS_TASK_STACK_SIZE`
+     * <li> ModbusError::FAILURE - The request queue or the bus task could not be created
+     * </ul>
+     */
+    ModbusError startRequestQueue(size_t length = CONFIG_DMM_REQUEST_QUEUE_LENGTH,
+                                  UBaseType_t priority = CONFIG_DMM_BUS_TASK_PRIORITY,
+                                  uint32_t stackSize = CONFIG_DMM_BUS_TASK_STACK_SIZE,
+                                  BaseType_t core = tskNO_AFFINITY);
+    
+    /**
+     * @brief Stop the bus task after all pending requests have been executed and destroy the request queue.
+     *
+     * @warning No asynchronous requests may be queued while the request queue is stopped.
+     *
+     * @return ModbusError::OK if the request queue was stopped, ModbusError::INVALID_STATE if it was not running.
+     */
+    ModbusError stopRequestQueue();
+    
+    /**
+     * @brief Get the request queue of this master.
+     *
+     * @return Non owning pointer to the request queue, `nullptr` if it is not running.
+     */
+    RequestQueue* getRequestQueue() const;
+    
+    /**
+     * @brief Get the latency histograms, retry, error and traffic counters of the requests of all slave devices
+     * attached to this master.
+     *
+     * @return The metrics of the bus, use RequestMetrics::snapshot to read them.
+     */
+    RequestMetrics& getMetrics() const;
+    
+    /**
+     * @brief Get the RAM occupied by this master, its transport, its request queue and every attached device.
+     *
+     * @details Allows to check the memory budget of a bus on the target, for example by logging it at startup.
+     *
+     * @return The memory footprint of the bus.
+     */
+    MemoryFootprint getMemoryFootprint() const;
+    
+    /**
+     * @brief Set the handler invoked with every request of an attached device that did not return ModbusError::OK.
+     *
+     * @details The handler is called by the task that sent the request, after all retries, including requests that
+     * were rejected since the device is quarantined. It must not block, ModbusErrorHelper::logRequestError logs the
+     * request without allocating. The number of failed requests per error is counted by the metrics regardless of
+     * the handler.
+     *
+     * @warning Must be set before requests are sent, the handler is not synchronised with the tasks invoking it.
+     *
+     * @param handler The handler, may be empty to disable it.
+     */
+    void setErrorHandler(ErrorHandler handler);
+    
+    /**
+     * @brief Pass a failed request to the error handler, if one is set.
+     *
+     * @param error The failed request.
+     */
+    void reportError(const RequestError& error) const;
 
 private:
-    ModbusConfig m_config;
-    void* m_context;
+    std::unique_ptr<transport::ModbusTransport> m_transport;
+    // Declared after the transport, so pending requests are completed before the transport is destroyed
+#if CONFIG_DMM_STATIC_POOLS
+    mutable std::optional<RequestQueue> m_requestQueue;
+#else
+    std::unique_ptr<RequestQueue> m_requestQueue;
+#endif
+    void* m_context = nullptr;
+    mutable RequestMetrics m_metrics;
+    ErrorHandler m_errorHandler;
 };
 }
 
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Dominik M. Glogowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_INPLACEFUNCTION_HPP
+#define DYNAMIC_MODBUS_MASTER_INPLACEFUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dynamic_modbus_master {
+
+template<typename Signature, size_t Capacity>
+class InplaceFunction;
+
+/**
+ * @brief Replacement for `std::function` that stores its target inside the object and never allocates.
+ *
+ * @details A callable larger than `Capacity` bytes is rejected at compile time instead of being moved to the heap,
+ * so the memory a queued request occupies is known when the firmware is built. Like `std::function` the target must be
+ * copy constructible, an empty function compares equal to `nullptr` and converts to `false`.
+ *
+ * @code{.cpp}
+ * InplaceFunction<void(ModbusError), 24> callback = [&counter](ModbusError error) { counter += (error == ModbusError::OK); };
+ * callback(ModbusError::OK);
+ * @endcode
+ *
+ * @tparam R The return type of the function.
+ * @tparam Args The argument types of the function.
+ * @tparam Capacity The maximum size of the stored callable in bytes.
+ */
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() = default;
+    
+    InplaceFunction(std::nullptr_t) {
+    }
+    
+    template<typename F, typename Target = std::decay_t<F>>
+    requires (!std::is_same_v<Target, InplaceFunction> && std::is_invocable_r_v<R, Target&, Args...>)
+    InplaceFunction(F&& target) {
+        static_assert(sizeof(Target) <= Capacity,
+                      "The callable exceeds the capacity of the function, capture less state or raise the capacity");
+        static_assert(alignof(Target) <= alignof(std::max_align_t), "The callable is over-aligned");
+        static_assert(std::is_copy_constructible_v<Target>, "The callable must be copy constructible");
+        if constexpr (std::is_pointer_v<Target> || std::is_member_pointer_v<Target> ||
+                      std::is_same_v<Target, std::function<R(Args...)>>) {
+            if (!target) {
+                return;
+            }
+        }
+        ::new(static_cast<void*>(m_storage)) Target(std::forward<F>(target));
+        m_operations = &OPERATIONS<Target>;
+    }
+    
+    InplaceFunction(const InplaceFunction& other) {
+        if (other.m_operations) {
+            other.m_operations->copy(m_storage, other.m_storage);
+            m_operations = other.m_operations;
+        }
+    }
+    
+    InplaceFunction(InplaceFunction&& other) noexcept {
+        if (other.m_operations) {
+            other.m_operations->move(m_storage, other.m_storage);
+            m_operations = other.m_operations;
+            other.reset();
+        }
+    }
+    
+    ~InplaceFunction() {
+        reset();
+    }
+    
+    InplaceFunction& operator=(const InplaceFunction& other) {
+        if (this != &other) {
+            InplaceFunction copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.m_operations) {
+                other.m_operations->move(m_storage, other.m_storage);
+                m_operations = other.m_operations;
+                other.reset();
+            }
+        }
+        return *this;
+    }
+    
+    InplaceFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+    
+    R operator()(Args... args) const {
+        return m_operations->invoke(const_cast<std::byte*>(m_storage), std::forward<Args>(args)...);
+    }
+    
+    explicit operator bool() const {
+        return m_operations != nullptr;
+    }
+    
+    friend bool operator==(const InplaceFunction& function, std::nullptr_t) {
+        return !function;
+    }
+
+private:
+    struct Operations {
+        R (*invoke)(std::byte* target, Args&&... args);
+        void (*copy)(std::byte* target, const std::byte* source);
+        void (*move)(std::byte* target, std::byte* source);
+        void (*destroy)(std::byte* target);
+    };
+    
+    template<typename Target>
+    static constexpr Operations OPERATIONS {
+        [](std::byte* target, Args&&... args) -> R {
+            return std::invoke(*std::launder(reinterpret_cast<Target*>(target)), std::forward<Args>(args)...);
+        },
+        [](std::byte* target, const std::byte* source) {
+            ::new(static_cast<void*>(target)) Target(*std::launder(reinterpret_cast<const Target*>(source)));
+        },
+        [](std::byte* target, std::byte* source) {
+            ::new(static_cast<void*>(target)) Target(std::move(*std::launder(reinterpret_cast<Target*>(source))));
+        },
+        [](std::byte* target) {
+            std::launder(reinterpret_cast<Target*>(target))->~Target();
+        },
+    };
+    
+    void reset() {
+        if (m_operations) {
+            m_operations->destroy(m_storage);
+            m_operations = nullptr;
+        }
+    }
+    
+    alignas(std::max_align_t) std::byte m_storage[Capacity];
+    const Operations* m_operations = nullptr;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_INPLACEFUNCTION_HPP
@@ -22,10 +22,20 @@
 #define DYNAMIC_MODBUS_MASTER_MODBUSDATA_HPP
 
 #include <cinttypes>
+#include <span>
 #include <type_traits>
 #include "ModbusError.h"
 
 namespace dynamic_modbus_master {
+/**
+ * @brief Detects `std::span` of any element type and extent.
+ */
+template<typename T>
+struct IsSpan : std::false_type {};
+
+template<typename T, size_t Extent>
+struct IsSpan<std::span<T, Extent>> : std::true_type {};
+
 /**
  * @brief Concept to check if a given Type T can be represented in modbus registers, constrains T to be
  * at least 16-Bits or the size of a single modbus Register.
@@ -35,12 +45,16 @@ namespace dynamic_modbus_master {
  * @f{eqnarray*}{
  * sizeof(T) \geq sizeof(\text{Modbus Register})
  * @f}
+ * Since the registers are copied into the memory of T, T must be trivially copyable, which excludes containers such as
+ * `std::vector`. Built-in arrays and `std::span` are excluded as well, a span is trivially copyable but only refers to
+ * the elements, so it selects the overloads for arrays instead.
  * @tparam T The type to check.
  */
 template<typename T>
 concept ModbusData =
-        (std::is_same_v<T, uint8_t>) || (std::is_same_v<T, bool>) ||
-        ((sizeof(T) % sizeof(uint16_t) == 0) && (sizeof(T) > 0));
+        std::is_trivially_copyable_v<T> && !std::is_array_v<T> && !IsSpan<T>::value &&
+        ((std::is_same_v<T, uint8_t>) || (std::is_same_v<T, bool>) ||
+        ((sizeof(T) % sizeof(uint16_t) == 0) && (sizeof(T) > 0)));
 
 namespace slave {
 
@@ -22,6 +22,7 @@
 #define DYNAMIC_MODBUS_MASTER_MODBUSERROR_H
 
 #include <cinttypes>
+#include <cstddef>
 
 namespace dynamic_modbus_master {
 /**
@@ -37,6 +38,8 @@ enum class ModbusError : uint8_t {
     INVALID_STATE = 6,          //!< The Modbus Driver or the Device is in an invalid state
     TIMEOUT = 7,                //!< The Driver experienced a timeout
     FAILURE = 8,                //!< The slave device experienced an undetermined failure.
+    QUEUE_FULL = 9,             //!< The request could not be queued since the request queue of the master is full
+    DEVICE_QUARANTINED = 10,    //!< The request was not sent since the device stopped responding and is quarantined
     // General Exception Codes
     ILLEGAL_FUNCTION = 11,      //!< The received Function code is not available on the target device
     ILLEGAL_DATA_ADDRESS = 12,  //!< The Data Address received is not available
@@ -50,6 +53,20 @@ enum class ModbusError : uint8_t {
     GATEWAY_PATH_UNAVAILABLE = 20,      //!< No Path was found between the Input and the Output Port of the Gateway, gateway is possibly misconfigured or overloaded
     GATEWAY_TARGET_NO_RESPONSE = 21,    //!< Gateway Target Device did not respond or does not exist.
 };
+
+constexpr size_t ERROR_CODES = 22;  //!< Number of dynamic_modbus_master::ModbusError values, including unused ones
+
+/**
+ * @brief Get the Modbus exception code a slave answered with.
+ *
+ * @param error The result of a request.
+ * @return The exception code transmitted by the slave, 0 if the result is not an exception.
+ */
+constexpr uint8_t toExceptionCode(ModbusError error) {
+    // The general exception codes are mapped to ModbusError with an offset of 10
+    auto value = static_cast<uint8_t>(error);
+    return value >= static_cast<uint8_t>(ModbusError::ILLEGAL_FUNCTION) ? value - 10 : 0;
+}
 }
 
 #endif //DYNAMIC_MODBUS_MASTER_MODBUSERROR_H
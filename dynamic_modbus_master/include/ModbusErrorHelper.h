@@ -22,80 +22,83 @@
 #define DYNAMIC_MODBUS_MASTER_MODBUSERRORHELPER_H
 
 #include <ModbusError.h>
-#include <string>
+#include <RequestError.h>
+#include <array>
+#include <cstddef>
+#include <string_view>
 
 namespace dynamic_modbus_master{
 
 class ModbusErrorHelper {
 public:
-/**
- * @brief Converts a ModbusError enum value to its corresponding name.
- * @param error The ModbusError enum value.
- * @return The name of the ModbusError.
- *
- * @details This function takes a ModbusError enum value and returns its corresponding
- * name as a string. The ModbusError enum represents different error types
- * that can occur in Modbus communication.
- */
-[[maybe_unused]] constexpr static std::string modbusErrorToName(const ModbusError error) {
-        switch (error) {
-            case ModbusError::OK:
-                return "OK";
-                break;
-            case ModbusError::INVALID_ARG:
-                return "INVALID_ARG";
-                break;
-            case ModbusError::INVALID_RESPONSE:
-                return "INVALID_RESPONSE";
-                break;
-            case ModbusError::ADDRESS_UNAVAILABLE:
-                return "ADDRESS_UNAVAILABLE";
-                break;
-            case ModbusError::SLAVE_NOT_SUPPORTED:
-                return "SLAVE_NOT_SUPPORTED";
-                break;
-            case ModbusError::PORT_NOT_SUPPORTED:
-                return "PORT_NOT_SUPPORTED";
-                break;
-            case ModbusError::INVALID_STATE:
-                return "INVALID_STATE";
-                break;
-            case ModbusError::TIMEOUT:
-                return "TIMEOUT";
-                break;
-            case ModbusError::FAILURE:
-                return "FAILURE";
-                break;
-            case ModbusError::ILLEGAL_FUNCTION:
-                return "ILLEGAL FUNCTION";
-                break;
-            case ModbusError::ILLEGAL_DATA_ADDRESS:
-                return "ILLEGAL DATA ADDRESS";
-                break;
-            case ModbusError::ILLEGAL_DATA_VALUE:
-                return "ILLEGAL DATA VALUE";
-                break;
-            case ModbusError::SLAVE_DEVICE_FAILURE:
-                return "SLAVE DEVICE FAILURE";
-                break;
-            case ModbusError::ACKNOWLEDGE:
-                return "ACKNOWLEDGE";
-                break;
-            case ModbusError::SLAVE_DEVICE_BUSY:
-                return "SLAVE DEVICE BUSY";
-                break;
-            case ModbusError::MEMORY_PARITY_ERROR:
-                return "MEMORY PARITY ERROR";
-                break;
-            case ModbusError::GATEWAY_PATH_UNAVAILABLE:
-                return "GATEWAY PATH UNAVAILABLE";
-                break;
-            case ModbusError::GATEWAY_TARGET_NO_RESPONSE:
-                return "GATEWAY TARGET NO RESPONSE";
-                break;
+    /**
+     * @brief The name of every ModbusError, indexed by its value. Values that are not used are empty.
+     */
+    static constexpr std::array<std::string_view, ERROR_CODES> ERROR_NAMES {
+        "OK",
+        "INVALID_ARG",
+        "INVALID_RESPONSE",
+        "ADDRESS_UNAVAILABLE",
+        "SLAVE_NOT_SUPPORTED",
+        "PORT_NOT_SUPPORTED",
+        "INVALID_STATE",
+        "TIMEOUT",
+        "FAILURE",
+        "QUEUE_FULL",
+        "DEVICE_QUARANTINED",
+        "ILLEGAL FUNCTION",
+        "ILLEGAL DATA ADDRESS",
+        "ILLEGAL DATA VALUE",
+        "SLAVE DEVICE FAILURE",
+        "ACKNOWLEDGE",
+        "SLAVE DEVICE BUSY",
+        "",
+        "MEMORY PARITY ERROR",
+        "",
+        "GATEWAY PATH UNAVAILABLE",
+        "GATEWAY TARGET NO RESPONSE",
+    };
+    
+    /**
+     * @brief Converts a ModbusError enum value to its corresponding name.
+     * @param error The ModbusError enum value.
+     * @return The name of the ModbusError.
+     *
+     * @details This function takes a ModbusError enum value and returns its corresponding
+     * name as a string. The ModbusError enum represents different error types
+     * that can occur in Modbus communication. The name refers to a string literal, so no memory is allocated and
+     * `data()` is null terminated and can be passed to `printf` style functions.
+     */
+    [[maybe_unused]] constexpr static std::string_view modbusErrorToName(const ModbusError error) {
+        auto index = static_cast<size_t>(error);
+        if (index >= ERROR_NAMES.size() || ERROR_NAMES[index].empty()) {
+            return "Invalid Error";
         }
-        return "Invalid Error";
+        return ERROR_NAMES[index];
     }
+    
+    /**
+     * @brief Write a single line describing a failed request into a buffer.
+     *
+     * @details For example `slave 12 fc 0x03 reg 100+4: SLAVE DEVICE BUSY (exception 0x06), 3 attempts in 182340 us`.
+     * Never allocates, the line is truncated if the buffer is too small.
+     *
+     * @param error The failed request.
+     * @param buffer The buffer to write the null terminated line to.
+     * @param size The size of the buffer.
+     * @return The length of the complete line, without the null terminator. The line was truncated if this is not
+     * less than `size`.
+     */
+    static size_t format(const RequestError& error, char* buffer, size_t size);
+    
+    /**
+     * @brief Error handler writing every failed request to the log as a warning.
+     *
+     * @details Can be passed directly to DynamicModbusMaster::setErrorHandler, the line is formatted on the stack.
+     *
+     * @param error The failed request.
+     */
+    static void logRequestError(const RequestError& error);
 };
 
 } // dynamic_modbus_master
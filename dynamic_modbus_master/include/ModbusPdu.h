@@ -0,0 +1,78 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_MODBUSPDU_H
+#define DYNAMIC_MODBUS_MASTER_MODBUSPDU_H
+
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include <cstddef>
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @brief The maximum size of a Modbus PDU, function code and data, in bytes.
+ */
+constexpr size_t MAX_PDU_SIZE = 253;
+
+/**
+ * @brief Encode the PDU of a request, used by transports that build their frames themselves.
+ *
+ * @details Supports the function codes 0x01 - 0x06, 0x0F, 0x10 and 0x17. Register values are encoded big-endian as
+ * required by the protocol, `data` is expected in the layout described in dynamic_modbus_master::ModbusRequest.
+ *
+ * @param request The request to encode.
+ * @param data Pointer to the request data, only read for writing requests.
+ * @param pdu Buffer of at least MAX_PDU_SIZE bytes the PDU is written to.
+ * @return The size of the PDU in bytes, 0 if the function code is not supported or the quantity of the request does
+ * not fit into a single PDU.
+ */
+size_t encodeRequestPdu(const ModbusRequest& request, const void* data, uint8_t* pdu);
+
+/**
+ * @brief Get the size of the PDU of a request without encoding it.
+ *
+ * @param request The request.
+ * @return The size of the PDU in bytes, 0 if the function code is not supported.
+ */
+size_t requestPduSize(const ModbusRequest& request);
+
+/**
+ * @brief Get the size of the PDU of a regular response to a request, exception responses are always 2 bytes.
+ *
+ * @param request The request.
+ * @return The size of the PDU in bytes.
+ */
+size_t responsePduSize(const ModbusRequest& request);
+
+/**
+ * @brief Decode the PDU of a response to a request.
+ *
+ * @param request The request that was answered.
+ * @param pdu The received PDU, starting with the function code.
+ * @param size The size of the received PDU in bytes.
+ * @param data Pointer to the request data, the values of reading requests are written to here.
+ * @return ModbusError::OK if the response is valid, the corresponding exception if the slave answered with an
+ * exception, ModbusError::INVALID_RESPONSE if the response does not match the request.
+ */
+ModbusError decodeResponsePdu(const ModbusRequest& request, const uint8_t* pdu, size_t size, void* data);
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_MODBUSPDU_H
@@ -0,0 +1,83 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_MODBUSREQUEST_H
+#define DYNAMIC_MODBUS_MASTER_MODBUSREQUEST_H
+
+#include <cinttypes>
+
+namespace dynamic_modbus_master {
+
+constexpr uint16_t MAX_READ_REGISTERS = 125;    //!< Maximum number of registers that can be read in a single request
+constexpr uint16_t MAX_WRITE_REGISTERS = 123;   //!< Maximum number of registers that can be written in a single request
+constexpr uint16_t MAX_READ_BITS = 2000;        //!< Maximum number of coils or discrete inputs that can be read in a single request
+constexpr uint16_t MAX_WRITE_BITS = 1968;       //!< Maximum number of coils that can be written in a single request
+constexpr uint16_t MAX_READ_WRITE_REGISTERS = 121;  //!< Maximum number of registers that can be written by Function Code 0x17
+
+/**
+ * @brief The four data tables of a Modbus slave, the values correspond to the function code reading the table.
+ */
+enum class RegisterType : uint8_t {
+    COIL = 0x01,            //!< Read/Write single bits
+    DISCRETE_INPUT = 0x02,  //!< Read-Only single bits
+    HOLDING = 0x03,         //!< Read/Write 16-Bit registers
+    INPUT = 0x04,           //!< Read-Only 16-Bit registers
+};
+
+/**
+ * @brief Check whether a register type addresses single bits rather than 16-Bit registers.
+ *
+ * @param type The register type to check.
+ * @return true for RegisterType::COIL and RegisterType::DISCRETE_INPUT, false otherwise.
+ */
+constexpr bool isBitType(RegisterType type) {
+    return type == RegisterType::COIL || type == RegisterType::DISCRETE_INPUT;
+}
+
+/**
+ * @struct ModbusRequest
+ * @brief Transport independent description of a single Modbus request.
+ *
+ * @details The data belonging to a request is passed alongside it as a `void*` and follows the layout used by
+ * esp-modbus: register functions (0x03, 0x04, 0x06, 0x10) use one host-order `uint16_t` per register, bit functions
+ * (0x01, 0x02, 0x0F) use bits packed LSB-first into bytes and function 0x05 uses a single `uint16_t` containing either
+ * 0xFF00 or 0x0000. Function 0x17 uses `writeSize` registers that are written, directly followed by `regSize` registers
+ * that receive the read data.
+ *
+ * @param slaveAddress The address of the targeted slave device.
+ * @param functionCode The Modbus function code of the request.
+ * @param regStart The first register or coil that is addressed by the request.
+ * @param regSize The number of registers or coils that are addressed by the request.
+ * @param writeStart The first register that is written, only used by Function Code 0x17.
+ * @param writeSize The number of registers that are written, only used by Function Code 0x17.
+ * @param timeoutMs The time in ms the slave may take to respond, 0 uses the default timeout of the transport.
+ */
+struct ModbusRequest {
+    uint8_t slaveAddress;
+    uint8_t functionCode;
+    uint16_t regStart;
+    uint16_t regSize;
+    uint16_t writeStart = 0;
+    uint16_t writeSize = 0;
+    uint32_t timeoutMs = 0;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_MODBUSREQUEST_H
@@ -0,0 +1,88 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_MODBUSTRANSPORT_H
+#define DYNAMIC_MODBUS_MASTER_MODBUSTRANSPORT_H
+
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include <cstddef>
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @brief Interface for the layer that moves Modbus requests onto a bus and returns the responses.
+ *
+ * @details A transport is owned by a dynamic_modbus_master::DynamicModbusMaster, every
+ * dynamic_modbus_master::slave::SlaveDevice attached to that master sends its requests through it.
+ * Implementations exist for esp-modbus serial communication (dynamic_modbus_master::transport::SerialTransport),
+ * native RTU communication (dynamic_modbus_master::transport::RtuTransport), Modbus TCP
+ * (dynamic_modbus_master::transport::TcpTransport) and for an in-process simulated bus
+ * (dynamic_modbus_master::transport::SimulatedTransport).
+ */
+class ModbusTransport {
+public:
+    virtual ~ModbusTransport() = default;
+    
+    /**
+     * @brief Start the transport, after this call requests may be sent.
+     *
+     * @return ModbusError::OK if the transport was started, otherwise an error describing the failure.
+     */
+    virtual ModbusError start() = 0;
+    
+    /**
+     * @brief Stop the transport, after this call no further requests may be sent until it is started again.
+     *
+     * @return ModbusError::OK if the transport was stopped, otherwise an error describing the failure.
+     */
+    virtual ModbusError stop() = 0;
+    
+    /**
+     * @brief Send a single request and wait for its response.
+     *
+     * @details Implementations do not retry, retrying is the responsibility of the caller. Implementations that
+     * support it wait at most `request.timeoutMs` for the response if it is not 0.
+     *
+     * @param request The request to send.
+     * @param data Pointer to the request data, see dynamic_modbus_master::ModbusRequest for the expected layout.
+     * In case of reading requests the response data will be written to here, in case of writing requests the data
+     * will be read from here.
+     * @return ModbusError::OK if the request was successful, ModbusError::TIMEOUT if the slave did not answer in time,
+     * the corresponding exception if the slave answered with an exception or any other error describing the failure.
+     */
+    virtual ModbusError sendRequest(const ModbusRequest& request, void* data) = 0;
+    
+    /**
+     * @brief Get the RAM the transport occupies.
+     *
+     * @details Includes the buffers and tasks the transport allocated itself. Memory of the drivers and protocol
+     * stacks it uses, like esp-modbus or lwIP, is not included. Transports that do not report their memory use
+     * return 0.
+     *
+     * @return The size of the transport in bytes.
+     */
+    virtual size_t memoryFootprint() const {
+        return 0;
+    }
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_MODBUSTRANSPORT_H
@@ -0,0 +1,212 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_MULTIBUSMASTER_H
+#define DYNAMIC_MODBUS_MASTER_MULTIBUSMASTER_H
+
+#include "DynamicModbusMaster.h"
+#include "ModbusError.h"
+#include "ScanScheduler.h"
+#include <freertos/FreeRTOS.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @struct ScanJobId
+ * @brief Identifies a scan job registered with a MultiBusMaster.
+ *
+ * @param bus The bus the job is executed on.
+ * @param id The id of the job within the ScanScheduler of the bus.
+ */
+struct ScanJobId {
+    size_t bus;
+    size_t id;
+};
+
+/**
+ * @brief Coordinator owning several masters, one per physical bus, each serviced by its own workers.
+ *
+ * @details Every bus consists of a DynamicModbusMaster, its request queue and a ScanScheduler. When started, the bus
+ * task of the request queue and the task of the scheduler of each bus are pinned to the core configured for the bus,
+ * so the buses communicate in parallel. Devices are assigned to a bus by constructing them with the master of that
+ * bus, apart from that application code is unchanged.
+ *
+ * @code{.cpp}
+ * dynamic_modbus_master::MultiBusMaster buses;
+ * buses.addBus(configUart1, 0);
+ * buses.addBus(configUart2, 1);
+ *
+ * SlaveDevice meter(1, 2, *buses.getMaster(0));
+ * SlaveDevice drive(1, 2, *buses.getMaster(1));
+ *
+ * buses.addJob(0, std::chrono::milliseconds(100), [&] { return meterMap.read(meter); });
+ * buses.addJob(1, std::chrono::milliseconds(20), [&] { return driveMap.read(drive); });
+ * buses.start();
+ * @endcode
+ *
+ * @note Buses are numbered in the order they were added.
+ * @warning Buses may only be added while the coordinator is stopped.
+ */
+class MultiBusMaster {
+public:
+    /**
+     * @brief Stops all buses.
+     */
+    ~MultiBusMaster();
+
+#if !CONFIG_IDF_TARGET_LINUX
+    /**
+     * @brief Add a bus using esp-modbus serial communication.
+     *
+     * @param config The configuration of the Modbus connection, every bus requires its own UART port.
+     * @param core The core the workers of the bus are pinned to, `tskNO_AFFINITY` to run them on any core.
+     * @return An instance of ModbusError representing the result of the initialisation of the master, see
+     * DynamicModbusMaster::initialise. The bus is only added if the initialisation was successful.
+     */
+    ModbusError addBus(ModbusConfig config, BaseType_t core = tskNO_AFFINITY);
+#endif
+    
+    /**
+     * @brief Add a bus using a custom transport.
+     *
+     * @param transport The transport of the bus.
+     * @param core The core the workers of the bus are pinned to, `tskNO_AFFINITY` to run them on any core.
+     * @return An instance of ModbusError representing the result of the initialisation of the master.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - The bus was added
+     * <li> ModbusError::INVALID_ARG - The transport was a `nullptr`
+     * <li> ModbusError::INVALID_STATE - The coordinator is running
+     * </ul>
+     */
+    ModbusError addBus(std::unique_ptr<transport::ModbusTransport> transport, BaseType_t core = tskNO_AFFINITY);
+    
+    /**
+     * @brief Get the number of buses.
+     *
+     * @return The number of buses.
+     */
+    size_t getBusCount() const;
+    
+    /**
+     * @brief Get the master of a bus, devices constructed with it are assigned to the bus.
+     *
+     * @param bus The bus.
+     * @return The master of the bus, `nullptr` if `bus` is not smaller than `getBusCount()`.
+     */
+    DynamicModbusMaster* getMaster(size_t bus) const;
+    
+    /**
+     * @brief Get the scan scheduler of a bus.
+     *
+     * @param bus The bus.
+     * @return The scan scheduler of the bus, `nullptr` if `bus` is not smaller than `getBusCount()`.
+     */
+    ScanScheduler* getScheduler(size_t bus) const;
+    
+    /**
+     * @brief Register a periodic job on a bus, see ScanScheduler::addJob.
+     *
+     * @param bus The bus.
+     * @param period The period with which the job is executed.
+     * @param job The job to execute, it must only communicate with devices of the same bus.
+     * @return The id of the job, its `id` is ScanScheduler::INVALID_ID if the job was rejected or the bus does not
+     * exist.
+     */
+    ScanJobId addJob(size_t bus, std::chrono::milliseconds period, ScanJob job);
+    
+    /**
+     * @brief Remove a job, it will not be executed again.
+     *
+     * @param id The id of the job.
+     * @return ModbusError::OK if the job was removed, ModbusError::INVALID_ARG if no job with this id exists.
+     */
+    ModbusError removeJob(ScanJobId id);
+    
+    /**
+     * @brief Get the execution statistics of a job.
+     *
+     * @param id The id of the job.
+     * @return The statistics of the job, all zero if no job with this id exists.
+     */
+    ScanStatistics getStatistics(ScanJobId id) const;
+    
+    /**
+     * @brief Get the combined execution statistics of the jobs of a single bus, see ScanScheduler::getStatistics.
+     *
+     * @param bus The bus.
+     * @return The combined statistics of the bus, all zero if the bus does not exist.
+     */
+    ScanStatistics getBusStatistics(size_t bus) const;
+    
+    /**
+     * @brief Get the combined execution statistics of the jobs of all buses.
+     *
+     * @return The combined statistics of all buses.
+     */
+    ScanStatistics getStatistics() const;
+    
+    /**
+     * @brief Start the transports, request queues and scan schedulers of all buses.
+     *
+     * @param priority The FreeRTOS priority of the workers.
+     * @param stackSize The stack size of each worker in bytes.
+     * @return ModbusError::OK if all buses were started, otherwise the first error that occurred, in which case all
+     * buses are stopped again.<br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The coordinator is already running
+     * <li> ModbusError::FAILURE - A worker could not be created
+     * <li> Any error of DynamicModbusMaster::start
+     * </ul>
+     */
+    ModbusError start(UBaseType_t priority = CONFIG_DMM_BUS_TASK_PRIORITY,
+                      uint32_t stackSize = CONFIG_DMM_BUS_TASK_STACK_SIZE);
+    
+    /**
+     * @brief Stop the scan schedulers, request queues and transports of all buses.
+     *
+     * @return ModbusError::OK if the buses were stopped, ModbusError::INVALID_STATE if the coordinator was not running.
+     */
+    ModbusError stop();
+
+private:
+    struct Bus {
+        explicit Bus(BaseType_t core): core(core) {
+        }
+        
+        BaseType_t core;
+        bool started = false;
+        DynamicModbusMaster master;
+        // Declared after the master, so the scheduler is stopped before the master is destroyed
+        ScanScheduler scheduler{master};
+    };
+    
+    std::vector<std::unique_ptr<Bus>> m_buses;
+    bool m_running = false;
+    
+    void stopBuses();
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_MULTIBUSMASTER_H
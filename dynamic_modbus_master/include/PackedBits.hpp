@@ -0,0 +1,213 @@
+// Copyright (c) 2024 Dominik M. Glogowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_PACKEDBITS_HPP
+#define DYNAMIC_MODBUS_MASTER_PACKEDBITS_HPP
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @brief Fixed size set of coils or discrete inputs, packed the way they are transmitted.
+ *
+ * @details Bit `i` is stored in bit `i % 8` of byte `i / 8`, the layout of Function Codes 0x01, 0x02 and 0x0F, so
+ * responses are received into and requests sent from the set without conversion. The bytes are held in 64-Bit words,
+ * counting, comparing and searching process 64 bits at a time. Bits beyond `N` are always zero.
+ *
+ * @code{.cpp}
+ * PackedBits<512> inputs;
+ * PackedBits<512> previous;
+ * device.readDiscreteInputs(0, inputs);   // 1 request
+ * inputs.changed(previous).forEach([](size_t bit) { ESP_LOGI(TAG, "Input %zu changed", bit); });
+ * previous = inputs;
+ * @endcode
+ *
+ * @tparam N The number of bits.
+ */
+template<size_t N>
+class PackedBits {
+    static_assert(N > 0, "A set of bits must contain at least one bit");
+    static_assert(std::endian::native == std::endian::little, "The wire layout requires a little-endian host");
+
+public:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t WORDS = (N + WORD_BITS - 1) / WORD_BITS;
+    
+    /**
+     * @brief Get the number of bits.
+     *
+     * @return N
+     */
+    static constexpr size_t size() {
+        return N;
+    }
+    
+    /**
+     * @brief Get the state of a bit.
+     *
+     * @param bit The index of the bit, must be less than N.
+     * @return The state of the bit.
+     */
+    constexpr bool test(size_t bit) const {
+        return (m_words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+    }
+    
+    /**
+     * @brief Set the state of a bit.
+     *
+     * @param bit The index of the bit, must be less than N.
+     * @param value The new state of the bit.
+     */
+    constexpr void set(size_t bit, bool value = true) {
+        const uint64_t mask = uint64_t{1} << (bit % WORD_BITS);
+        m_words[bit / WORD_BITS] = (value ? m_words[bit / WORD_BITS] | mask : m_words[bit / WORD_BITS] & ~mask);
+    }
+    
+    /**
+     * @brief Clear all bits.
+     */
+    constexpr void clear() {
+        m_words.fill(0);
+    }
+    
+    /**
+     * @brief Count the set bits.
+     *
+     * @return The number of set bits.
+     */
+    constexpr size_t count() const {
+        size_t result = 0;
+        for (uint64_t word : m_words) {
+            result += std::popcount(word);
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Check whether any bit is set.
+     *
+     * @return True if at least one bit is set.
+     */
+    constexpr bool any() const {
+        for (uint64_t word : m_words) {
+            if (word != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Get the bits that differ from another set, e.g. the result of the previous scan.
+     *
+     * @param other The set to compare with.
+     * @return A set with all bits set that differ between both sets.
+     */
+    constexpr PackedBits changed(const PackedBits& other) const {
+        PackedBits result;
+        for (size_t i = 0; i < WORDS; i++) {
+            result.m_words[i] = m_words[i] ^ other.m_words[i];
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Find the first set bit at or after a position.
+     *
+     * @param from The index to start searching at.
+     * @return The index of the set bit, N if there is none.
+     */
+    constexpr size_t findNext(size_t from) const {
+        if (from >= N) {
+            return N;
+        }
+        size_t index = from / WORD_BITS;
+        uint64_t word = m_words[index] & (~uint64_t{0} << (from % WORD_BITS));
+        while (word == 0) {
+            if (++index == WORDS) {
+                return N;
+            }
+            word = m_words[index];
+        }
+        return index * WORD_BITS + std::countr_zero(word);
+    }
+    
+    /**
+     * @brief Invoke a function for the index of every set bit, in ascending order.
+     *
+     * @param function Invoked with the index of every set bit.
+     */
+    template<typename Function>
+    constexpr void forEach(Function function) const {
+        for (size_t i = 0; i < WORDS; i++) {
+            for (uint64_t word = m_words[i]; word != 0; word &= word - 1) {
+                function(i * WORD_BITS + std::countr_zero(word));
+            }
+        }
+    }
+    
+    /**
+     * @brief Get the packed bytes in the layout of the Modbus protocol.
+     *
+     * @return Pointer to `bytes()` bytes.
+     */
+    uint8_t* data() {
+        return reinterpret_cast<uint8_t*>(m_words.data());
+    }
+    
+    /**
+     * @brief Get the packed bytes in the layout of the Modbus protocol.
+     *
+     * @return Pointer to `bytes()` bytes.
+     */
+    const uint8_t* data() const {
+        return reinterpret_cast<const uint8_t*>(m_words.data());
+    }
+    
+    /**
+     * @brief Get the number of bytes needed to hold N bits.
+     *
+     * @return The number of bytes.
+     */
+    static constexpr size_t bytes() {
+        return (N + 7) / 8;
+    }
+    
+    /**
+     * @brief Clear the bits beyond N, after the bytes have been written through `data()`.
+     */
+    constexpr void clearPadding() {
+        if constexpr (N % WORD_BITS != 0) {
+            m_words[WORDS - 1] &= (uint64_t{1} << (N % WORD_BITS)) - 1;
+        }
+    }
+    
+    constexpr bool operator==(const PackedBits& other) const = default;
+
+private:
+    std::array<uint64_t, WORDS> m_words{};
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_PACKEDBITS_HPP
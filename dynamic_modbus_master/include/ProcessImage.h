@@ -0,0 +1,283 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_PROCESSIMAGE_H
+#define DYNAMIC_MODBUS_MASTER_PROCESSIMAGE_H
+
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include "SlaveDevice.h"
+#include "WordOrder.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @brief Handle of a point in a dynamic_modbus_master::ProcessImage, returned by ProcessImage::add.
+ *
+ * @tparam T The type of the point.
+ * @tparam Order The word order the device transmits the point in.
+ */
+template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+struct ImagePoint {
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    
+    uint32_t index = INVALID_INDEX;
+    
+    /**
+     * @brief Check whether the point was added to the image.
+     *
+     * @return False if ProcessImage::add rejected the point.
+     */
+    constexpr bool valid() const {
+        return index != INVALID_INDEX;
+    }
+};
+
+/**
+ * @struct ImageStatistics
+ * @brief Statistics of a dynamic_modbus_master::ProcessImage.
+ *
+ * @param updates The number of requests whose response was written to the image.
+ * @param failures The number of requests that failed, the image keeps the previous values of their points.
+ * @param readRetries The number of times a reader had to repeat a read, since the values were updated concurrently.
+ */
+struct ImageStatistics {
+    uint32_t updates;
+    uint32_t failures;
+    uint32_t readRetries;
+};
+
+/**
+ * @struct ImageBlock
+ * @brief A request of a dynamic_modbus_master::ProcessImage and the range of the register table it occupies.
+ *
+ * @param device The device that is read.
+ * @param type The register type that is read.
+ * @param regStart The first register of the request.
+ * @param regSize The number of registers of the request.
+ * @param offset The index of the first register in the register table.
+ */
+struct ImageBlock {
+    const slave::SlaveDevice* device;
+    RegisterType type;
+    uint16_t regStart;
+    uint16_t regSize;
+    uint32_t offset;
+};
+
+/**
+ * @brief Process image holding the polled holding and input registers of all devices of a master.
+ *
+ * @details Points of all devices are added while setting up the image. Points of the same device and register type
+ * are merged into as few requests as possible, the same way as by dynamic_modbus_master::slave::ReadPlan, and every
+ * request gets a contiguous range of a single register table. The layout is fixed by the first `update`, afterwards
+ * points can no longer be added.
+ *
+ * `update` reads the devices and is called by a single task, typically as a job of a
+ * dynamic_modbus_master::ScanScheduler. Any number of tasks read points through `read` without locks and without
+ * communicating with a device. Every request is protected by a sequence lock: a read that overlaps with an update of
+ * the same request is repeated, so values spanning multiple registers are never torn.
+ *
+ * @code{.cpp}
+ * ProcessImage image;
+ * ImagePoint<float, WordOrder::ABCD> power = image.add<float, WordOrder::ABCD>(meter, RegisterType::INPUT, 12);
+ * ImagePoint<uint16_t> state = image.add<uint16_t>(drive, RegisterType::HOLDING, 1);
+ * scheduler.addJob(std::chrono::milliseconds(100), [&] { return image.update(); });
+ *
+ * // Any task
+ * slave::SlaveReturn<float> value = image.read(power);
+ * @endcode
+ *
+ * @note A reader with a higher priority than the updating task on the same core delays itself for a tick after
+ * repeated retries, so the update it interrupted can complete.
+ */
+class ProcessImage {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Invoked by the updating task after a request was written to the image, with the index of the request in
+     * `getBlocks`, the registers of the response, the result of the request and the time of the update. The registers
+     * are only valid if the result is ModbusError::OK.
+     */
+    using UpdateListener = std::function<void(size_t block, const uint16_t* registers, ModbusError error,
+                                              Clock::time_point updated)>;
+    
+    /**
+     * @brief Creates an empty process image.
+     *
+     * @param maxGap The maximum number of unused registers between two points of a device that are still read with a
+     * single request. The unused registers are read and discarded, so they must be readable on the device.
+     */
+    explicit ProcessImage(uint16_t maxGap = 0);
+    
+    ProcessImage(const ProcessImage&) = delete;
+    ProcessImage& operator=(const ProcessImage&) = delete;
+    
+    /**
+     * @brief Add a point to the image.
+     *
+     * @tparam T The type of the point. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device transmits the point in.
+     * @param device The device the point is read from, must outlive the image.
+     * @param type The register type of the point, RegisterType::HOLDING or RegisterType::INPUT.
+     * @param reg The first register of the point.
+     * @return The handle of the point, invalid if the register type is not a register, the point exceeds the address
+     * range or the layout of the image is already fixed.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB> requires (sizeof(T) % sizeof(uint16_t) == 0)
+    ImagePoint<T, Order> add(const slave::SlaveDevice& device, RegisterType type, uint16_t reg) {
+        static_assert(sizeof(T) / sizeof(uint16_t) <= MAX_READ_REGISTERS, "Points must fit into a single request");
+        return {addPoint(device, type, reg, sizeof(T) / sizeof(uint16_t))};
+    }
+    
+    /**
+     * @brief Read all devices and write the responses to the image, fixing the layout on the first call.
+     *
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError update();
+    
+    /**
+     * @brief Read the points of a single device and write the responses to the image, allows to update devices with
+     * different periods.
+     *
+     * @param device The device to read.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError update(const slave::SlaveDevice& device);
+    
+    /**
+     * @brief Fix the layout without reading the devices, e.g. to export it before the first update. Points can no
+     * longer be added afterwards.
+     */
+    void fixLayout();
+    
+    /**
+     * @brief Get the requests of the image and their ranges of the register table.
+     *
+     * @return The requests ordered by their offset, empty until the layout is fixed.
+     */
+    std::vector<ImageBlock> getBlocks() const;
+    
+    /**
+     * @brief Set the function invoked after every update of a request, replacing the previous one.
+     *
+     * @param listener The listener, empty to remove it. Waits until an update in progress completes.
+     */
+    void setUpdateListener(UpdateListener listener);
+    
+    /**
+     * @brief Read a point from the image, never blocks and never communicates with the device.
+     *
+     * @param point The point to read.
+     * @return The last value read from the device and the error of the last update of its request.
+     * ModbusError::INVALID_STATE if the point has not been updated yet, ModbusError::INVALID_ARG if the point is
+     * invalid.
+     */
+    template<ModbusData T, WordOrder Order>
+    slave::SlaveReturn<T> read(const ImagePoint<T, Order>& point) const {
+        uint16_t registers[sizeof(T) / sizeof(uint16_t)];
+        ModbusError error = readPoint(point.index, registers, sizeof(T) / sizeof(uint16_t));
+        T value{};
+        convertRegisters<T, Order>(registers, &value, 1);
+        return {error, value};
+    }
+    
+    /**
+     * @brief Get the time the request of a point was last updated successfully.
+     *
+     * @param point The point.
+     * @return The time of the last successful update, `Clock::time_point::min()` if there was none.
+     */
+    template<ModbusData T, WordOrder Order>
+    Clock::time_point updated(const ImagePoint<T, Order>& point) const {
+        return updatedAt(point.index);
+    }
+    
+    /**
+     * @brief Get the size of the register table.
+     *
+     * @return The number of registers, 0 until the layout is fixed.
+     */
+    size_t size() const;
+    
+    /**
+     * @brief Get the statistics of the image.
+     *
+     * @return The statistics since the image was created.
+     */
+    ImageStatistics getStatistics() const;
+
+private:
+    struct Point {
+        const slave::SlaveDevice* device;
+        RegisterType type;
+        uint16_t reg;
+        uint16_t size;
+        uint32_t block;
+        uint32_t offset;
+    };
+    
+    struct Block {
+        const slave::SlaveDevice* device;
+        RegisterType type;
+        uint16_t regStart;
+        uint16_t regSize;
+        uint32_t offset;
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<ModbusError> error{ModbusError::INVALID_STATE};
+        std::atomic<Clock::rep> updated{Clock::time_point::min().time_since_epoch().count()};
+    };
+    
+    uint16_t m_maxGap;
+    std::mutex m_writeMutex;
+    std::atomic<bool> m_fixed = false;
+    std::vector<Point> m_points;
+    std::unique_ptr<Block[]> m_blocks;
+    size_t m_blockCount = 0;
+    std::unique_ptr<uint16_t[]> m_table;
+    size_t m_tableSize = 0;
+    std::atomic<uint32_t> m_updates = 0;
+    std::atomic<uint32_t> m_failures = 0;
+    mutable std::atomic<uint32_t> m_readRetries = 0;
+    UpdateListener m_listener;
+    
+    uint32_t addPoint(const slave::SlaveDevice& device, RegisterType type, uint16_t reg, uint16_t size);
+    
+    ModbusError readPoint(uint32_t index, uint16_t* registers, uint16_t size) const;
+    
+    Clock::time_point updatedAt(uint32_t index) const;
+    
+    void layout();
+    
+    ModbusError update(Block& block);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_PROCESSIMAGE_H
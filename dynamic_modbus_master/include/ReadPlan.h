@@ -0,0 +1,162 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_READPLAN_H
+#define DYNAMIC_MODBUS_MASTER_READPLAN_H
+
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include <cstddef>
+#include <vector>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @struct ReadBlock
+ * @brief A single read request that was planned by dynamic_modbus_master::slave::ReadPlan.
+ *
+ * @param type The register type that is read by the request.
+ * @param regStart The first register or bit of the request.
+ * @param regSize The number of registers or bits of the request.
+ * @param firstPoint Index of the first point served by this request, in the planned order.
+ * @param pointCount The number of points served by this request.
+ */
+struct ReadBlock {
+    RegisterType type;
+    uint16_t regStart;
+    uint16_t regSize;
+    size_t firstPoint;
+    size_t pointCount;
+};
+
+/**
+ * @brief Set of typed points that are read from a single slave device with the minimum number of requests.
+ *
+ * @details Points are merged into a single request when they have the same register type and are adjacent,
+ * overlapping or separated by no more than the configured gap, as long as the request does not exceed
+ * MAX_READ_REGISTERS registers or MAX_READ_BITS bits. The plan is computed once when it is first executed and reused
+ * until further points are added.
+ *
+ * Executing the plan via dynamic_modbus_master::slave::SlaveDevice::read(ReadPlan&) writes the data and error of every
+ * request into the `SlaveReturn` of each point it serves.
+ *
+ * @code{.cpp}
+ * SlaveReturn<uint16_t> single{};
+ * SlaveReturn<uint32_t> multiple{};
+ * SlaveReturn<float> value{};
+ *
+ * ReadPlan plan;
+ * plan.add(RegisterType::HOLDING, 1, single);
+ * plan.add(RegisterType::HOLDING, 2, multiple);
+ * plan.add(RegisterType::HOLDING, 4, value);
+ *
+ * // Reads registers 1 - 5 in a single request
+ * device.read(plan);
+ * @endcode
+ *
+ * @warning The plan stores pointers to the `SlaveReturn` targets, they must outlive the plan.
+ */
+class ReadPlan {
+public:
+    /**
+     * @brief Creates an empty read plan.
+     *
+     * @param maxGap The maximum number of unused registers or bits between two points that are still merged into a
+     * single request. The unused registers are read and discarded, so they must be readable on the device.
+     */
+    explicit ReadPlan(uint16_t maxGap = 0);
+    
+    /**
+     * @brief Add a typed point to the plan.
+     *
+     * @details Register points occupy `sizeof(T) / 2` registers. Bit points occupy a single bit for `bool` and
+     * `sizeof(T) * 8` bits otherwise, the bits are packed LSB-first into `target.data`. Types that do not occupy whole
+     * registers, `bool` and `uint8_t`, are only valid for coils and discrete inputs, register points of these types are
+     * not added and their error is set to ModbusError::INVALID_ARG. The same applies to points that do not fit into a
+     * single request, i.e. more than MAX_READ_REGISTERS registers or MAX_READ_BITS bits.
+     *
+     * @tparam T The type of the point. This type must meet the `ModbusData` concept requirements.
+     * @param type The register type of the point.
+     * @param reg The first register or bit of the point.
+     * @param target The return value the data and error of the point are written to when the plan is executed.
+     */
+    template<ModbusData T>
+    void add(RegisterType type, uint16_t reg, SlaveReturn<T>& target) {
+        size_t size;
+        if (isBitType(type)) {
+            size = (std::is_same_v<T, bool> ? 1 : sizeof(T) * 8);
+        } else if constexpr (sizeof(T) % sizeof(uint16_t) == 0) {
+            size = sizeof(T) / sizeof(uint16_t);
+        } else {
+            target.error = ModbusError::INVALID_ARG;
+            return;
+        }
+        if (size > (isBitType(type) ? MAX_READ_BITS : MAX_READ_REGISTERS)) {
+            target.error = ModbusError::INVALID_ARG;
+            return;
+        }
+        m_points.push_back(Point{type, reg, static_cast<uint16_t>(size), &target.data, &target.error,
+                                 std::is_same_v<T, bool>});
+        m_planned = false;
+    }
+    
+    /**
+     * @brief Remove all points from the plan.
+     */
+    void clear();
+    
+    /**
+     * @brief Get the requests necessary to read all points, computing the plan if necessary.
+     *
+     * @return The planned requests, ordered by register type and start register.
+     */
+    const std::vector<ReadBlock>& getBlocks();
+    
+    /**
+     * @brief Distribute the response of a planned request to the points it serves.
+     *
+     * @param block The request the response belongs to, must be one of the blocks returned by `getBlocks`.
+     * @param buffer The response data in the layout described in dynamic_modbus_master::ModbusRequest.
+     * @param error The result of the request, the data is only distributed if this is ModbusError::OK.
+     */
+    void scatter(const ReadBlock& block, const void* buffer, ModbusError error);
+
+private:
+    struct Point {
+        RegisterType type;
+        uint16_t reg;
+        uint16_t size;
+        void* data;
+        ModbusError* error;
+        bool isBool;
+    };
+    
+    uint16_t m_maxGap;
+    bool m_planned = false;
+    std::vector<Point> m_points;
+    std::vector<size_t> m_order;
+    std::vector<ReadBlock> m_blocks;
+    
+    void plan();
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_READPLAN_H
@@ -0,0 +1,155 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_REGISTERCACHE_H
+#define DYNAMIC_MODBUS_MASTER_REGISTERCACHE_H
+
+#include "ModbusRequest.h"
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @struct CacheStatistics
+ * @brief Effectiveness of a dynamic_modbus_master::slave::RegisterCache.
+ *
+ * @param hits The number of lookups that were served from the cache.
+ * @param misses The number of lookups that required a request, because a register was missing or expired.
+ * @param invalidations The number of registers that were removed from the cache by writes.
+ */
+struct CacheStatistics {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t invalidations;
+};
+
+/**
+ * @brief Compact store of the last known values of the registers and bits of a single slave device.
+ *
+ * @details Every register or bit is stored with the time its value expires, which is determined by the time to live
+ * of the register when it is stored. A lookup of several consecutive registers only succeeds if all of them are
+ * present and have not yet expired. The cache is safe to be used from several tasks.
+ *
+ * Bits are stored as a register with the value 0 or 1.
+ */
+class RegisterCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Creates an empty cache.
+     *
+     * @param defaultTtl The time to live of all registers without a specific time to live, 0 disables caching.
+     */
+    explicit RegisterCache(std::chrono::milliseconds defaultTtl);
+    
+    /**
+     * @brief Set the time to live of a range of registers or bits, overrides previously set values for the range.
+     *
+     * @details Only affects values that are stored afterwards.
+     *
+     * @param type The register type of the range.
+     * @param reg The first register or bit of the range.
+     * @param count The number of registers or bits of the range.
+     * @param ttl The time to live, 0 disables caching of the range.
+     */
+    void setTtl(RegisterType type, uint16_t reg, uint16_t count, std::chrono::milliseconds ttl);
+    
+    /**
+     * @brief Look up the values of consecutive registers or bits and count the result as hit or miss.
+     *
+     * @param type The register type.
+     * @param reg The first register or bit.
+     * @param count The number of registers or bits.
+     * @param values Buffer of `count` registers the values are written to, only on success.
+     * @param now The current time.
+     * @return true if all values are cached and not expired.
+     */
+    bool lookup(RegisterType type, uint16_t reg, uint16_t count, uint16_t* values, Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Store the values of consecutive registers or bits.
+     *
+     * @param type The register type.
+     * @param reg The first register or bit.
+     * @param count The number of registers or bits.
+     * @param values The values of the registers, for bits 0 or 1.
+     * @param now The time the values were read.
+     */
+    void store(RegisterType type, uint16_t reg, uint16_t count, const uint16_t* values,
+               Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Remove consecutive registers or bits from the cache, so they are read from the device again.
+     *
+     * @param type The register type.
+     * @param reg The first register or bit.
+     * @param count The number of registers or bits.
+     */
+    void invalidate(RegisterType type, uint16_t reg, uint16_t count);
+    
+    /**
+     * @brief Remove all registers and bits from the cache.
+     */
+    void clear();
+    
+    /**
+     * @brief Get the hit and miss counters of the cache.
+     *
+     * @return A snapshot of the counters.
+     */
+    CacheStatistics getStatistics() const;
+    
+    /**
+     * @brief Reset the hit and miss counters to 0.
+     */
+    void resetStatistics();
+
+private:
+    struct Entry {
+        uint16_t reg;
+        uint16_t value;
+        Clock::time_point expiry;
+    };
+    
+    struct TtlRule {
+        RegisterType type;
+        uint16_t regStart;
+        uint16_t regSize;
+        Clock::duration ttl;
+    };
+    
+    mutable std::mutex m_mutex;
+    Clock::duration m_defaultTtl;
+    std::vector<TtlRule> m_rules;
+    // One table per register type, sorted by register
+    std::array<std::vector<Entry>, 4> m_tables;
+    CacheStatistics m_statistics{};
+    
+    std::vector<Entry>& table(RegisterType type);
+    
+    Clock::duration ttl(RegisterType type, uint16_t reg) const;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_REGISTERCACHE_H
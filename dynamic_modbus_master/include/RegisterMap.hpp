@@ -0,0 +1,361 @@
+// Copyright (c) 2024 Dominik M. Glogowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_REGISTERMAP_HPP
+#define DYNAMIC_MODBUS_MASTER_REGISTERMAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include "ModbusData.hpp"
+#include "ModbusRequest.h"
+#include "SlaveDevice.h"
+#include "WordOrder.hpp"
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @brief String literal usable as a template argument, used to name the points of a register map.
+ *
+ * @tparam N The length of the string including the terminating null character.
+ */
+template<size_t N>
+struct PointName {
+    char value[N];
+    
+    constexpr PointName(const char (&name)[N]) {
+        for (size_t i = 0; i < N; i++) {
+            value[i] = name[i];
+        }
+    }
+    
+    constexpr std::string_view view() const {
+        return {value, N - 1};
+    }
+};
+
+/**
+ * @brief Compile-time description of a single point of a register map.
+ *
+ * @tparam Name The name the point is accessed by.
+ * @tparam Type The register type of the point.
+ * @tparam Address The first register or bit of the point.
+ * @tparam T The type of the point. This type must meet the `ModbusData` concept requirements.
+ * @tparam Order The word order of the point, only relevant for register points spanning multiple registers.
+ */
+template<PointName Name, RegisterType Type, uint16_t Address, ModbusData T, WordOrder Order = WordOrder::CDAB>
+struct Point {
+    static_assert(isBitType(Type) || sizeof(T) >= sizeof(uint16_t),
+            "Register points must span at least one register");
+    
+    using ValueType = T;
+    static constexpr std::string_view name = Name.view();
+    static constexpr RegisterType type = Type;
+    static constexpr uint16_t address = Address;
+    static constexpr WordOrder order = Order;
+    static constexpr uint16_t size = (isBitType(Type) ? (std::is_same_v<T, bool> ? 1 : sizeof(T) * 8)
+                                                     : sizeof(T) / sizeof(uint16_t));
+};
+
+/**
+ * @brief Register map of a slave device, with all requests necessary to read it computed at compile time.
+ *
+ * @details The points are merged into the minimum number of requests in the same manner as
+ * dynamic_modbus_master::slave::ReadPlan, but without any planning at runtime or dynamic memory. The map owns a buffer
+ * that is sized to hold exactly the data of all requests. Overlapping points, duplicate names and points exceeding the
+ * address range or the protocol limits fail to compile.
+ *
+ * @code{.cpp}
+ * using ExampleMap = RegisterMap<
+ *         Point<"single", RegisterType::HOLDING, 1, uint16_t>,
+ *         Point<"multiple", RegisterType::HOLDING, 2, uint32_t>,
+ *         Point<"float", RegisterType::HOLDING, 4, float, WordOrder::ABCD>,
+ *         Point<"coil", RegisterType::COIL, 0, bool>>;
+ *
+ * ExampleMap map;
+ * map.read(device);                        // 2 requests
+ * SlaveReturn<float> value = map.get<"float">();
+ * @endcode
+ *
+ * @tparam MaxGap The maximum number of unused registers or bits between two points that are still merged into a single
+ * request. The unused registers are read and discarded, so they must be readable on the device.
+ * @tparam Points The points of the map, see dynamic_modbus_master::slave::Point.
+ */
+template<uint16_t MaxGap, typename... Points>
+class BasicRegisterMap {
+public:
+    /**
+     * @struct Block
+     * @brief A single read request of the map.
+     *
+     * @param type The register type that is read by the request.
+     * @param regStart The first register or bit of the request.
+     * @param regSize The number of registers or bits of the request.
+     * @param bufferOffset The offset of the request data in the buffer of the map, in registers.
+     */
+    struct Block {
+        RegisterType type;
+        uint16_t regStart;
+        uint16_t regSize;
+        size_t bufferOffset;
+    };
+
+private:
+    struct PointInfo {
+        RegisterType type;
+        uint16_t address;
+        uint16_t size;
+        std::string_view name;
+    };
+    
+    static constexpr size_t POINT_COUNT = sizeof...(Points);
+    static constexpr std::array<PointInfo, POINT_COUNT> POINTS = {
+            PointInfo{Points::type, Points::address, Points::size, Points::name}...
+    };
+    
+    static constexpr uint32_t limitOf(RegisterType type) {
+        return (isBitType(type) ? MAX_READ_BITS : MAX_READ_REGISTERS);
+    }
+    
+    static constexpr uint32_t endOf(const PointInfo& point) {
+        return static_cast<uint32_t>(point.address) + point.size;
+    }
+    
+    static constexpr size_t bufferSizeOf(RegisterType type, uint16_t size) {
+        return (isBitType(type) ? (size + 15) / 16 : size);
+    }
+    
+    static constexpr std::array<size_t, POINT_COUNT> sortPoints() {
+        std::array<size_t, POINT_COUNT> order{};
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            order[i] = i;
+        }
+        for (size_t i = 1; i < POINT_COUNT; i++) {
+            for (size_t j = i; j > 0; j--) {
+                const PointInfo& left = POINTS[order[j - 1]];
+                const PointInfo& right = POINTS[order[j]];
+                if (left.type < right.type || (left.type == right.type && left.address <= right.address)) {
+                    break;
+                }
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+        return order;
+    }
+    
+    static constexpr std::array<size_t, POINT_COUNT> ORDER = sortPoints();
+    
+    static constexpr bool pointsInRange() {
+        for (const PointInfo& point : POINTS) {
+            if (endOf(point) > 0x10000 || point.size > limitOf(point.type)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    static constexpr bool pointsDisjoint() {
+        for (size_t i = 1; i < POINT_COUNT; i++) {
+            const PointInfo& previous = POINTS[ORDER[i - 1]];
+            const PointInfo& current = POINTS[ORDER[i]];
+            if (previous.type == current.type && endOf(previous) > current.address) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    static constexpr bool namesUnique() {
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            for (size_t j = i + 1; j < POINT_COUNT; j++) {
+                if (POINTS[i].name == POINTS[j].name) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    static_assert(pointsInRange(), "A point exceeds the address range or the maximum size of a single request");
+    static_assert(pointsDisjoint(), "Two points of the same register type overlap");
+    static_assert(namesUnique(), "Two points share the same name");
+    
+    /**
+     * @brief Merges the sorted points into blocks, storing the block of every point if `pointBlocks` is provided.
+     *
+     * @return The number of blocks.
+     */
+    static constexpr size_t planBlocks(Block* blocks, size_t* pointBlocks) {
+        size_t count = 0;
+        Block current{};
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            const PointInfo& point = POINTS[ORDER[i]];
+            if (count > 0) {
+                uint32_t blockEnd = static_cast<uint32_t>(current.regStart) + current.regSize;
+                uint32_t mergedEnd = (blockEnd > endOf(point) ? blockEnd : endOf(point));
+                if (current.type == point.type && point.address <= blockEnd + MaxGap &&
+                    mergedEnd - current.regStart <= limitOf(point.type)) {
+                    current.regSize = static_cast<uint16_t>(mergedEnd - current.regStart);
+                    if (blocks) {
+                        blocks[count - 1] = current;
+                    }
+                    if (pointBlocks) {
+                        pointBlocks[ORDER[i]] = count - 1;
+                    }
+                    continue;
+                }
+                current.bufferOffset += bufferSizeOf(current.type, current.regSize);
+            }
+            current.type = point.type;
+            current.regStart = point.address;
+            current.regSize = point.size;
+            if (blocks) {
+                blocks[count] = current;
+            }
+            if (pointBlocks) {
+                pointBlocks[ORDER[i]] = count;
+            }
+            count++;
+        }
+        return count;
+    }
+
+public:
+    static constexpr size_t BLOCK_COUNT = planBlocks(nullptr, nullptr);  //!< Number of requests necessary to read the map
+    
+    static constexpr std::array<Block, BLOCK_COUNT> BLOCKS = [] {
+        std::array<Block, BLOCK_COUNT> blocks{};
+        std::array<size_t, POINT_COUNT> pointBlocks{};
+        planBlocks(blocks.data(), pointBlocks.data());
+        return blocks;
+    }();  //!< The requests necessary to read the map, ordered by register type and start register
+    
+    static constexpr size_t BUFFER_SIZE = [] {
+        size_t size = 0;
+        for (const Block& block : BLOCKS) {
+            size += bufferSizeOf(block.type, block.regSize);
+        }
+        return size;
+    }();  //!< Size of the buffer of the map in registers
+
+private:
+    static constexpr std::array<size_t, POINT_COUNT> POINT_BLOCKS = [] {
+        std::array<Block, BLOCK_COUNT> blocks{};
+        std::array<size_t, POINT_COUNT> pointBlocks{};
+        planBlocks(blocks.data(), pointBlocks.data());
+        return pointBlocks;
+    }();
+    
+    template<PointName Name>
+    static constexpr size_t indexOf() {
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            if (POINTS[i].name == Name.view()) {
+                return i;
+            }
+        }
+        return POINT_COUNT;
+    }
+    
+    template<size_t Index, typename First, typename... Rest>
+    struct PointAt {
+        using Type = typename PointAt<Index - 1, Rest...>::Type;
+    };
+    
+    template<typename First, typename... Rest>
+    struct PointAt<0, First, Rest...> {
+        using Type = First;
+    };
+    
+    std::array<uint16_t, BUFFER_SIZE> m_buffer{};
+    // Blocks report ModbusError::INVALID_STATE until they were read, like the points of a ProcessImage
+    std::array<ModbusError, BLOCK_COUNT> m_errors = [] {
+        std::array<ModbusError, BLOCK_COUNT> errors{};
+        errors.fill(ModbusError::INVALID_STATE);
+        return errors;
+    }();
+
+public:
+    /**
+     * @brief Reads all points of the map from a device, using the precomputed requests.
+     *
+     * @param device The device to read the map from.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError read(const SlaveDevice& device) {
+        ModbusError result = ModbusError::OK;
+        for (size_t i = 0; i < BLOCK_COUNT; i++) {
+            const Block& block = BLOCKS[i];
+            m_errors[i] = device.readBlock(block.type, block.regStart, block.regSize,
+                                           m_buffer.data() + block.bufferOffset);
+            if (result == ModbusError::OK) {
+                result = m_errors[i];
+            }
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Decodes a point from the data of the last `read`.
+     *
+     * @tparam Name The name of the point, unknown names fail to compile.
+     * @return A `SlaveReturn` containing the decoded value and the error of the request that read the point,
+     * ModbusError::INVALID_STATE before the first `read`.
+     */
+    template<PointName Name>
+    SlaveReturn<typename PointAt<indexOf<Name>(), Points...>::Type::ValueType> get() const {
+        constexpr size_t index = indexOf<Name>();
+        static_assert(index < POINT_COUNT, "The register map has no point with this name");
+        using PointType = typename PointAt<index, Points...>::Type;
+        using T = typename PointType::ValueType;
+        
+        constexpr Block block = BLOCKS[POINT_BLOCKS[index]];
+        constexpr uint16_t offset = PointType::address - block.regStart;
+        const uint16_t* data = m_buffer.data() + block.bufferOffset;
+        
+        SlaveReturn<T> result{m_errors[POINT_BLOCKS[index]], T{}};
+        if constexpr (!isBitType(PointType::type)) {
+            result.data = decodeRegisters<T, PointType::order>(data + offset);
+        } else {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+            if constexpr (std::is_same_v<T, bool>) {
+                result.data = (bytes[offset / 8] & (1 << (offset % 8))) != 0;
+            } else {
+                auto* target = reinterpret_cast<uint8_t*>(&result.data);
+                for (uint16_t bit = 0; bit < PointType::size; bit++) {
+                    uint16_t sourceBit = offset + bit;
+                    if (bytes[sourceBit / 8] & (1 << (sourceBit % 8))) {
+                        target[bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+                    }
+                }
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Register map merging only adjacent points, see dynamic_modbus_master::slave::BasicRegisterMap.
+ */
+template<typename... Points>
+using RegisterMap = BasicRegisterMap<0, Points...>;
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_REGISTERMAP_HPP
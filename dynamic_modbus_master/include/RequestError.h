@@ -0,0 +1,58 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_REQUESTERROR_H
+#define DYNAMIC_MODBUS_MASTER_REQUESTERROR_H
+
+#include "ModbusError.h"
+#include <cinttypes>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @struct RequestError
+ * @brief Description of a failed request, passed to the error handler of a dynamic_modbus_master::DynamicModbusMaster.
+ *
+ * @details Holds everything needed to tell a field fault from its log line alone and contains no pointers, so it can
+ * be copied into a queue or ring buffer without allocating. Use ModbusErrorHelper::format to turn it into text.
+ *
+ * @param error The result of the request.
+ * @param slaveAddress The address of the slave the request was sent to.
+ * @param functionCode The function code of the request.
+ * @param exceptionCode The exception code the slave answered with, 0 if it did not answer with an exception.
+ * @param regStart The first register or bit of the request.
+ * @param regSize The number of registers or bits of the request.
+ * @param attempts The number of attempts sent, 0 if the request was rejected before it was sent.
+ * @param elapsedUs The time from the first attempt until the result, including the delays between retries, in
+ * microseconds.
+ */
+struct RequestError {
+    ModbusError error;
+    uint8_t slaveAddress;
+    uint8_t functionCode;
+    uint8_t exceptionCode;
+    uint16_t regStart;
+    uint16_t regSize;
+    uint8_t attempts;
+    uint32_t elapsedUs;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_REQUESTERROR_H
@@ -0,0 +1,169 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_REQUESTMETRICS_H
+#define DYNAMIC_MODBUS_MASTER_REQUESTMETRICS_H
+
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace dynamic_modbus_master {
+
+constexpr size_t LATENCY_BUCKETS = 12;              //!< Number of buckets of a latency histogram
+constexpr uint32_t FIRST_LATENCY_BUCKET_US = 500;   //!< Upper bound of the first latency bucket, doubled per bucket
+
+/**
+ * @brief The function codes for which latency histograms are kept.
+ */
+constexpr std::array<uint8_t, 9> METRIC_FUNCTION_CODES{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x0F, 0x10, 0x17};
+
+/**
+ * @struct FunctionMetrics
+ * @brief Latency histogram of a single function code.
+ *
+ * @param functionCode The function code.
+ * @param attempts The number of attempts that were sent with this function code, including timed out attempts.
+ * @param latency The number of attempts per latency bucket. Bucket `i` counts the attempts that took less than
+ * FIRST_LATENCY_BUCKET_US * 2^i microseconds and were not counted by a lower bucket, the last bucket counts all
+ * remaining attempts.
+ */
+struct FunctionMetrics {
+    uint8_t functionCode;
+    uint32_t attempts;
+    std::array<uint32_t, LATENCY_BUCKETS> latency;
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Copy of the counters of a dynamic_modbus_master::RequestMetrics at a point in time.
+ *
+ * @details All counters wrap around on overflow, rates should be calculated from the difference of two snapshots.
+ *
+ * @param functions The latency histogram of every function code in METRIC_FUNCTION_CODES, in the same order.
+ * @param errors The number of requests per result, indexed by the value of dynamic_modbus_master::ModbusError.
+ * @param requests The number of requests, a request with retries counts once.
+ * @param retries The number of attempts that were retries of a request.
+ * @param bytesSent The number of PDU bytes that were sent.
+ * @param bytesReceived The number of PDU bytes that were received.
+ */
+struct MetricsSnapshot {
+    std::array<FunctionMetrics, METRIC_FUNCTION_CODES.size()> functions;
+    std::array<uint32_t, ERROR_CODES> errors;
+    uint32_t requests;
+    uint32_t retries;
+    uint32_t bytesSent;
+    uint32_t bytesReceived;
+    
+    /**
+     * @brief Get the histogram of a function code.
+     *
+     * @param functionCode The function code.
+     * @return Pointer to the histogram, `nullptr` if no histogram is kept for this function code.
+     */
+    const FunctionMetrics* function(uint8_t functionCode) const;
+    
+    /**
+     * @brief Get the number of requests that resulted in an error.
+     *
+     * @param error The result to count.
+     * @return The number of requests with this result.
+     */
+    uint32_t errorCount(ModbusError error) const;
+};
+
+/**
+ * @brief Lock-free counters describing the requests of a slave device or of all devices of a master.
+ *
+ * @details Every attempt of a request is recorded in the latency histogram of its function code and in the byte
+ * counters, the final result of a request is recorded once in the error counters. Updates are relaxed atomic
+ * increments and never block, `snapshot` copies the counters one by one, so a snapshot taken while requests are
+ * recorded may mix the counts of consecutive requests.
+ *
+ * Copies start with the counts of the original.
+ */
+class RequestMetrics {
+public:
+    RequestMetrics() = default;
+    
+    RequestMetrics(const RequestMetrics& other);
+    
+    RequestMetrics& operator=(const RequestMetrics& other);
+    
+    /**
+     * @brief Record a single attempt of a request.
+     *
+     * @param request The request that was sent.
+     * @param result The result of the attempt.
+     * @param latency The time from sending the request until its response or timeout.
+     */
+    void recordAttempt(const ModbusRequest& request, ModbusError result, std::chrono::microseconds latency);
+    
+    /**
+     * @brief Record the final result of a request.
+     *
+     * @param result The result of the last attempt.
+     * @param attempts The number of attempts, retries are all attempts but the first.
+     */
+    void recordRequest(ModbusError result, uint8_t attempts);
+    
+    /**
+     * @brief Copy the current counters.
+     *
+     * @return The snapshot.
+     */
+    MetricsSnapshot snapshot() const;
+    
+    /**
+     * @brief Set all counters to 0.
+     */
+    void reset();
+    
+    /**
+     * @brief Get the latency bucket an attempt is counted in.
+     *
+     * @param latency The latency of the attempt.
+     * @return The index of the bucket.
+     */
+    static size_t latencyBucket(std::chrono::microseconds latency);
+
+private:
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Metrics require lock-free 32-Bit atomics");
+    
+    struct Histogram {
+        std::atomic<uint32_t> attempts{0};
+        std::array<std::atomic<uint32_t>, LATENCY_BUCKETS> latency{};
+    };
+    
+    std::array<Histogram, METRIC_FUNCTION_CODES.size()> m_functions{};
+    std::array<std::atomic<uint32_t>, ERROR_CODES> m_errors{};
+    std::atomic<uint32_t> m_requests{0};
+    std::atomic<uint32_t> m_retries{0};
+    std::atomic<uint32_t> m_bytesSent{0};
+    std::atomic<uint32_t> m_bytesReceived{0};
+    
+    void add(const MetricsSnapshot& counts);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_REQUESTMETRICS_H
@@ -0,0 +1,276 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_REQUESTQUEUE_H
+#define DYNAMIC_MODBUS_MASTER_REQUESTQUEUE_H
+
+#include "InplaceFunction.hpp"
+#include "ModbusError.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sdkconfig.h>
+
+namespace dynamic_modbus_master {
+
+#if CONFIG_DMM_STATIC_POOLS
+/**
+ * @brief A request that is executed by the bus task of a RequestQueue, including the invocation of its callback.
+ *
+ * @details Stored inside the queue entry, a request capturing more than `CONFIG_DMM_ASYNC_REQUEST_SIZE` bytes does not
+ * compile.
+ */
+using AsyncRequest = InplaceFunction<void(), CONFIG_DMM_ASYNC_REQUEST_SIZE>;
+
+/**
+ * @brief Callback receiving the result of an asynchronous request.
+ *
+ * @details Stored inside the request, a callback capturing more than `CONFIG_DMM_CALLBACK_SIZE` bytes does not compile.
+ */
+template<typename Signature>
+using RequestCallback = InplaceFunction<Signature, CONFIG_DMM_CALLBACK_SIZE>;
+#else
+/**
+ * @brief A request that is executed by the bus task of a RequestQueue, including the invocation of its callback.
+ */
+using AsyncRequest = std::function<void()>;
+
+/**
+ * @brief Callback receiving the result of an asynchronous request.
+ */
+template<typename Signature>
+using RequestCallback = std::function<Signature>;
+#endif
+
+/**
+ * @brief Priority classes of a RequestQueue, from the most to the least urgent.
+ */
+enum class RequestPriority : uint8_t {
+    CRITICAL = 0,   //!< Alarms and safety related requests, always executed first
+    CONTROL = 1,    //!< Setpoints and commands of control loops
+    MONITORING = 2, //!< Cyclic reads of process values
+    BACKGROUND = 3, //!< Configuration, diagnostics and other requests without deadline
+};
+
+constexpr size_t REQUEST_PRIORITIES = 4;    //!< Number of dynamic_modbus_master::RequestPriority classes
+
+/**
+ * @struct PriorityStatistics
+ * @brief Queue times of the requests of a single priority class of a dynamic_modbus_master::RequestQueue.
+ *
+ * @param executed The number of requests that were executed.
+ * @param promoted The number of requests that were executed ahead of higher classes, since they waited too long.
+ * @param totalQueueTimeUs The sum of the time all executed requests waited in the queue in microseconds.
+ * @param maxQueueTimeUs The longest time a request waited in the queue in microseconds.
+ */
+struct PriorityStatistics {
+    uint32_t executed;
+    uint32_t promoted;
+    uint64_t totalQueueTimeUs;
+    uint32_t maxQueueTimeUs;
+};
+
+/**
+ * @struct QueueStatistics
+ * @brief Queue times of a dynamic_modbus_master::RequestQueue.
+ *
+ * @param priorities The statistics of every priority class, indexed by the value of RequestPriority.
+ */
+struct QueueStatistics {
+    std::array<PriorityStatistics, REQUEST_PRIORITIES> priorities;
+};
+
+/**
+ * @brief Queue of asynchronous requests of a master, serviced by a dedicated bus task.
+ *
+ * @details Requests are executed one after another. Every request belongs to a dynamic_modbus_master::RequestPriority
+ * class, the bus task always executes the oldest request of the most urgent class that has requests pending. So
+ * that lower classes are not starved by a steady stream of more urgent requests, a request that waited longer than
+ * the maximum wait is executed before all classes but RequestPriority::CRITICAL. Requests of the same class are
+ * executed in the order they were queued. This allows application tasks to continue while their requests are on the
+ * bus and removes the need for one task per device.
+ *
+ * The queue is created by dynamic_modbus_master::DynamicModbusMaster::startRequestQueue and used by the asynchronous
+ * methods of dynamic_modbus_master::slave::SlaveDevice.
+ */
+class RequestQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Creates a stopped request queue.
+     *
+     * @param length The maximum number of pending requests per priority class. With `CONFIG_DMM_STATIC_POOLS` the
+     * entries are part of the queue and the length is limited to `CONFIG_DMM_REQUEST_QUEUE_LENGTH`.
+     * @param maxWait The time after which a request is executed ahead of higher priority classes.
+     */
+    explicit RequestQueue(size_t length,
+                          std::chrono::milliseconds maxWait = std::chrono::milliseconds(CONFIG_DMM_REQUEST_QUEUE_MAX_WAIT_MS));
+    
+    /**
+     * @brief Stops the bus task, executing all requests that are still pending.
+     */
+    ~RequestQueue();
+    
+    /**
+     * @brief Start the bus task.
+     *
+     * @param priority The FreeRTOS priority of the bus task.
+     * @param stackSize The stack size of the bus task in bytes. With `CONFIG_DMM_STATIC_POOLS` the stack is part of the
+     * queue and the size is limited to `CONFIG_DMM_BUS_TASK_STACK_SIZE`.
+     * @param core The core the bus task is pinned to, `tskNO_AFFINITY` to run it on any core.
+     * @return ModbusError::OK if the task was started. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The task is already running.
+     * <li> ModbusError::INVALID_ARG - The stack size exceeds `CONFIG_DMM_BUS_TASK_STACK_SIZE` with static pools.
+     * <li> ModbusError::FAILURE - The queue or the task could not be created.
+     * </ul>
+     */
+    ModbusError start(UBaseType_t priority, uint32_t stackSize, BaseType_t core);
+    
+    /**
+     * @brief Stop the bus task after all requests that are still pending have been executed.
+     *
+     * @details Requests queued concurrently are either executed or rejected by `enqueue`. Should a request remain
+     * queued once the task stopped, it is discarded and a caller waiting for it in `execute` receives
+     * ModbusError::INVALID_STATE. The task is deleted before this returns, so the queue can be destroyed or started
+     * again right away.
+     *
+     * @return ModbusError::OK if the task was stopped, ModbusError::INVALID_STATE if it was not running.
+     */
+    ModbusError stop();
+    
+    /**
+     * @brief Queue a request for execution by the bus task.
+     *
+     * @param request The request to execute.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The bus task is not running.
+     * <li> ModbusError::QUEUE_FULL - The maximum number of pending requests of the priority class was reached.
+     * </ul>
+     */
+    ModbusError enqueue(AsyncRequest request, RequestPriority priority = RequestPriority::MONITORING);
+    
+    /**
+     * @brief Queue a request and wait until the bus task executed it.
+     *
+     * @details Allows tasks that communicate synchronously to take part in the arbitration of the bus.
+     *
+     * @warning Must not be called from a request executed by the bus task, since it would wait for itself.
+     *
+     * @param request The request to execute.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was executed, ModbusError::INVALID_STATE if the bus task stopped before
+     * executing it, otherwise the error of `enqueue`.
+     */
+    ModbusError execute(AsyncRequest request, RequestPriority priority);
+    
+    /**
+     * @brief Get the number of requests that are waiting for execution.
+     *
+     * @return The number of pending requests of all priority classes.
+     */
+    size_t pending() const;
+    
+    /**
+     * @brief Get the number of requests of a priority class that are waiting for execution.
+     *
+     * @param priority The priority class.
+     * @return The number of pending requests of the class.
+     */
+    size_t pending(RequestPriority priority) const;
+    
+    /**
+     * @brief Get the queue times of all priority classes.
+     *
+     * @return A snapshot of the statistics.
+     */
+    QueueStatistics getStatistics() const;
+    
+    /**
+     * @brief Set the statistics of all priority classes to 0.
+     */
+    void resetStatistics();
+    
+    /**
+     * @brief Get the RAM the queue occupies.
+     *
+     * @return The size of the queue, its entries and the stack of the bus task in bytes.
+     */
+    size_t memoryFootprint() const;
+
+private:
+    // A caller of `execute` waiting for its request
+    struct Waiter {
+        SemaphoreHandle_t done;
+        ModbusError result;
+    };
+    
+    struct Entry {
+        AsyncRequest request;
+        Clock::time_point queued;
+        Waiter* waiter = nullptr;
+    };
+    
+    size_t m_length;
+    Clock::duration m_maxWait;
+    mutable std::mutex m_mutex;
+    // One ring buffer of m_length entries per priority class
+#if CONFIG_DMM_STATIC_POOLS
+    std::array<Entry, REQUEST_PRIORITIES * CONFIG_DMM_REQUEST_QUEUE_LENGTH> m_entries;
+    std::array<StackType_t, CONFIG_DMM_BUS_TASK_STACK_SIZE / sizeof(StackType_t)> m_stack;
+    StaticTask_t m_taskBuffer;
+    StaticSemaphore_t m_availableBuffer;
+    StaticSemaphore_t m_stoppedBuffer;
+#else
+    std::unique_ptr<Entry[]> m_entries;
+    uint32_t m_stackSize = 0;
+#endif
+    std::array<size_t, REQUEST_PRIORITIES> m_first{};
+    std::array<size_t, REQUEST_PRIORITIES> m_count{};
+    QueueStatistics m_statistics{};
+    SemaphoreHandle_t m_available = nullptr;
+    SemaphoreHandle_t m_stopped = nullptr;
+    TaskHandle_t m_task = nullptr;
+    std::atomic<bool> m_running = false;
+    
+    Entry& at(size_t priority, size_t position);
+    
+    ModbusError push(AsyncRequest request, RequestPriority priority, Waiter* waiter);
+    
+    bool next(Entry& entry);
+    
+    void discardPending();
+    
+    static void task(void* queue);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_REQUESTQUEUE_H
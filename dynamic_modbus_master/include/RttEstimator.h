@@ -0,0 +1,110 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_RTTESTIMATOR_H
+#define DYNAMIC_MODBUS_MASTER_RTTESTIMATOR_H
+
+#include <sdkconfig.h>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @brief Round-trip time estimate of a single slave device, used to derive its response timeout and retry delays.
+ *
+ * @details Follows the retransmission timer of TCP (RFC 6298): every measured round-trip time updates an
+ * exponentially weighted mean (gain 1/8) and mean deviation (gain 1/4), the timeout is the mean plus four times the
+ * deviation. Every timeout doubles the current timeout until the next measurement, the result is always clamped to
+ * the configured minimum and maximum.
+ *
+ * Until the first measurement no timeout is proposed and the default timeout of the transport applies.
+ *
+ * The estimate is updated with relaxed atomic operations, concurrent updates from several tasks may lose a sample
+ * but never corrupt the estimate. Copies start with the estimate of the original.
+ */
+class RttEstimator {
+public:
+    /**
+     * @brief Creates an estimator without any measurement.
+     *
+     * @param minTimeout The lower bound of the proposed timeout.
+     * @param maxTimeout The upper bound of the proposed timeout.
+     */
+    explicit RttEstimator(std::chrono::milliseconds minTimeout = std::chrono::milliseconds(CONFIG_DMM_RTT_MIN_TIMEOUT_MS),
+                          std::chrono::milliseconds maxTimeout = std::chrono::milliseconds(CONFIG_DMM_RTT_MAX_TIMEOUT_MS));
+    
+    RttEstimator(const RttEstimator& other);
+    
+    RttEstimator& operator=(const RttEstimator& other);
+    
+    /**
+     * @brief Add a measured round-trip time and reset the timeout backoff.
+     *
+     * @param rtt The time between sending a request and receiving its response.
+     */
+    void addSample(std::chrono::microseconds rtt);
+    
+    /**
+     * @brief Record a timeout, doubling the proposed timeout until the next sample.
+     */
+    void addTimeout();
+    
+    /**
+     * @brief Get the response timeout for the next request.
+     *
+     * @return The proposed timeout, 0 if no round-trip time was measured yet.
+     */
+    std::chrono::milliseconds timeout() const;
+    
+    /**
+     * @brief Get the delay before a retry, doubling with every attempt and randomised to spread out retries.
+     *
+     * @param attempt The number of the failed attempt, starting at 1.
+     * @return A delay between half and all of `CONFIG_DMM_RETRY_BACKOFF_MS` * 2^(attempt - 1), limited to
+     * `CONFIG_DMM_RETRY_BACKOFF_MAX_MS`.
+     */
+    static std::chrono::milliseconds retryDelay(uint8_t attempt);
+    
+    /**
+     * @brief Get the smoothed round-trip time.
+     *
+     * @return The mean round-trip time, 0 if no round-trip time was measured yet.
+     */
+    std::chrono::microseconds smoothedRtt() const;
+    
+    /**
+     * @brief Get the mean deviation of the round-trip time.
+     *
+     * @return The mean deviation, 0 if no round-trip time was measured yet.
+     */
+    std::chrono::microseconds rttVariation() const;
+
+private:
+    uint32_t m_minTimeoutUs;
+    uint32_t m_maxTimeoutUs;
+    std::atomic<uint32_t> m_srttUs{0};
+    std::atomic<uint32_t> m_rttvarUs{0};
+    std::atomic<uint8_t> m_backoff{0};
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_RTTESTIMATOR_H
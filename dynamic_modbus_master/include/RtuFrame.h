@@ -0,0 +1,83 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_RTUFRAME_H
+#define DYNAMIC_MODBUS_MASTER_RTUFRAME_H
+
+#include "ModbusError.h"
+#include "ModbusPdu.h"
+#include "ModbusRequest.h"
+#include <cstddef>
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @brief The maximum size of a Modbus RTU frame in bytes, address, PDU and CRC.
+ */
+constexpr size_t MAX_RTU_FRAME_SIZE = 1 + MAX_PDU_SIZE + 2;
+
+/**
+ * @brief The size of an RTU exception response in bytes, which is also the smallest possible response.
+ */
+constexpr size_t RTU_EXCEPTION_SIZE = 5;
+
+/**
+ * @brief Compute the Modbus CRC16 of a buffer.
+ *
+ * @details Table-driven, processes a byte per table lookup instead of a bit per iteration.
+ *
+ * @param data The buffer.
+ * @param size The size of the buffer in bytes.
+ * @return The CRC16, transmitted low byte first.
+ */
+uint16_t crc16(const uint8_t* data, size_t size);
+
+/**
+ * @brief Build an RTU request frame directly into a transmit buffer.
+ *
+ * @param request The request to encode.
+ * @param data Pointer to the request data, only read for writing requests.
+ * @param frame Buffer of at least MAX_RTU_FRAME_SIZE bytes the frame is written to.
+ * @return The size of the frame in bytes, 0 if the request can not be encoded, see encodeRequestPdu.
+ */
+size_t encodeRtuRequest(const ModbusRequest& request, const void* data, uint8_t* frame);
+
+/**
+ * @brief Get the size of the frame a slave answers a request with, if it does not answer with an exception.
+ *
+ * @param request The request.
+ * @return The size of the response frame in bytes.
+ */
+size_t rtuResponseSize(const ModbusRequest& request);
+
+/**
+ * @brief Check address and CRC of a received response frame and decode it into the request data.
+ *
+ * @param request The request that was answered.
+ * @param frame The received frame.
+ * @param size The size of the received frame in bytes.
+ * @param data Pointer to the request data, the values of reading requests are written to here.
+ * @return ModbusError::OK if the response is valid, the corresponding exception if the slave answered with an
+ * exception, ModbusError::INVALID_RESPONSE if the frame is corrupted or does not match the request.
+ */
+ModbusError decodeRtuResponse(const ModbusRequest& request, const uint8_t* frame, size_t size, void* data);
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_RTUFRAME_H
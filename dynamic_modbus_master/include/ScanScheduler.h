@@ -0,0 +1,205 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SCANSCHEDULER_H
+#define DYNAMIC_MODBUS_MASTER_SCANSCHEDULER_H
+
+#include "DynamicModbusMaster.h"
+#include "ModbusError.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <sdkconfig.h>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @brief A single bus transaction or group of transactions executed periodically by the ScanScheduler.
+ */
+using ScanJob = std::function<ModbusError()>;
+
+/**
+ * @struct ScanStatistics
+ * @brief Execution statistics of a single scan job.
+ *
+ * @param executions The number of times the job was executed.
+ * @param overruns The number of cycles in which the job completed after its deadline or was not executed at all.
+ * @param failures The number of executions that did not return ModbusError::OK.
+ * @param lastError The result of the last execution.
+ * @param maxLatenessUs The largest amount of time a job completed after its deadline in microseconds.
+ */
+struct ScanStatistics {
+    uint32_t executions;
+    uint32_t overruns;
+    uint32_t failures;
+    ModbusError lastError;
+    uint32_t maxLatenessUs;
+};
+
+/**
+ * @brief Periodic scan engine scheduling the bus transactions of all devices attached to a master.
+ *
+ * @details Jobs are registered with a period, each period the job is released once and has to complete before the
+ * next release. Released jobs are executed earliest deadline first, so jobs with short periods are preferred over slow
+ * ones when both are due. Completing after the deadline or missing a cycle entirely is counted as an overrun.
+ *
+ * When no job is due, a job may be started early if its next release is within a fraction of its period. This spreads
+ * slow jobs that would otherwise be released at the same time over the idle time of the bus, without changing their
+ * cadence.
+ *
+ * The scheduler is either driven by calling `poll` from an application task, or by its own task started via `start`.
+ *
+ * @code{.cpp}
+ * dynamic_modbus_master::ScanScheduler scheduler(master);
+ * scheduler.addJob(std::chrono::milliseconds(100), [&] { return controlMap.read(device); });
+ * scheduler.addJob(std::chrono::seconds(60), [&] { return device.read(configurationPlan); });
+ * scheduler.start();
+ * @endcode
+ */
+class ScanScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr size_t INVALID_ID = SIZE_MAX;  //!< Returned by `addJob` if the job was rejected
+    
+    /**
+     * @brief Creates a scheduler for the devices attached to a master.
+     *
+     * @param master The master the scheduled jobs communicate through.
+     * @param idleFillPercent How early, in percent of its period, a job may be started when the bus is idle. 0 disables
+     * early execution.
+     */
+    explicit ScanScheduler(const DynamicModbusMaster& master, uint8_t idleFillPercent = 25);
+    
+    /**
+     * @brief Stops the scheduler task if it is running.
+     */
+    ~ScanScheduler();
+    
+    /**
+     * @brief Register a job, its first release is immediate.
+     *
+     * @param period The period with which the job is executed, must be positive.
+     * @param job The job to execute, may add and remove jobs of this scheduler.
+     * @return The id of the job, used to remove the job or query its statistics. INVALID_ID if the period is not
+     * positive or the job is empty.
+     */
+    size_t addJob(std::chrono::milliseconds period, ScanJob job);
+    
+    /**
+     * @brief Remove a job, it will not be executed again.
+     *
+     * @details A job that is currently executing is removed once it completes.
+     *
+     * @param id The id of the job.
+     * @return ModbusError::OK if the job was removed, ModbusError::INVALID_ARG if no job with this id exists.
+     */
+    ModbusError removeJob(size_t id);
+    
+    /**
+     * @brief Get the execution statistics of a job.
+     *
+     * @param id The id of the job.
+     * @return The statistics of the job, all zero if no job with this id exists.
+     */
+    ScanStatistics getStatistics(size_t id) const;
+    
+    /**
+     * @brief Get the combined execution statistics of all jobs.
+     *
+     * @return The sum of the executions, overruns and failures of all jobs, the largest lateness of any job and the
+     * last error of a failing job, ModbusError::OK if the last execution of every job succeeded.
+     */
+    ScanStatistics getStatistics() const;
+    
+    /**
+     * @brief Execute the most urgent job, if any is due or may be started early.
+     *
+     * @details The job is executed without holding the lock of the scheduler, so the other methods do not wait for
+     * the bus transaction. A job is never executed by two calls at the same time.
+     *
+     * @param now The current time.
+     * @return true if a job was executed, false if the bus is idle until `nextStart`.
+     */
+    bool poll(Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Get the earliest time at which the next job may be started.
+     *
+     * @return The earliest start time, `Clock::time_point::max()` if no jobs are registered.
+     */
+    Clock::time_point nextStart() const;
+    
+    /**
+     * @brief Start a task that executes the jobs.
+     *
+     * @param priority The FreeRTOS priority of the task.
+     * @param stackSize The stack size of the task in bytes.
+     * @param core The core the task is pinned to, `tskNO_AFFINITY` to run it on any core.
+     * @return ModbusError::OK if the task was started. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The task is already running or the master was not initialised.
+     * <li> ModbusError::FAILURE - The task could not be created.
+     * </ul>
+     */
+    ModbusError start(UBaseType_t priority = CONFIG_DMM_BUS_TASK_PRIORITY,
+                      uint32_t stackSize = CONFIG_DMM_BUS_TASK_STACK_SIZE,
+                      BaseType_t core = tskNO_AFFINITY);
+    
+    /**
+     * @brief Stop the task started by `start`, waits until a job that is currently executing completes.
+     *
+     * @return ModbusError::OK if the task was stopped, ModbusError::INVALID_STATE if it was not running.
+     */
+    ModbusError stop();
+
+private:
+    struct Job {
+        size_t id;
+        Clock::duration period;
+        Clock::time_point release;
+        ScanJob job;
+        ScanStatistics statistics;
+        bool running;   // Executed by `poll` without the lock held, must not be erased
+        bool removed;   // Removed while running, erased once it completed
+    };
+    
+    const DynamicModbusMaster& m_master;
+    uint8_t m_idleFillPercent;
+    mutable std::mutex m_mutex;
+    // A list keeps the job that is executing in place while jobs are added or removed
+    std::list<Job> m_jobs;
+    size_t m_nextId = 0;
+    std::atomic<bool> m_running = false;
+    SemaphoreHandle_t m_stopped = nullptr;
+    
+    Clock::time_point earliestStart(const Job& job) const;
+    
+    static void task(void* scheduler);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SCANSCHEDULER_H
@@ -0,0 +1,119 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SERIALTRANSPORT_H
+#define DYNAMIC_MODBUS_MASTER_SERIALTRANSPORT_H
+
+#include "ModbusTransport.h"
+#include "ModbusConfiguration.h"
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @brief Transport sending requests over a serial line using esp-modbus.
+ *
+ * @details Wraps an esp-modbus serial master context. This is the transport that is created by
+ * dynamic_modbus_master::DynamicModbusMaster::initialise(ModbusConfig).
+ */
+class SerialTransport : public ModbusTransport {
+public:
+    /**
+     * @brief Creates an uninitialised serial transport.
+     *
+     * @param config The configuration of the Modbus connection.
+     */
+    explicit SerialTransport(ModbusConfig config);
+    
+    /**
+     * @brief Destroys the previously with `initialise` allocated esp-modbus master context.
+     */
+    ~SerialTransport() override;
+    
+    /**
+     * @brief Create the esp-modbus serial master and set up the UART pins.
+     *
+     * @return An instance of ModbusError representing the result of the initialization.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - Initalisation was successful
+     * <li> ModbusError::PORT_NOT_SUPPORTED - The MB Port Type was not supported
+     * <li> ModbusError::INVALID_STATE - Inialisation failure
+     * <li> ModbusError::FAILURE - Undetermined Failure
+     * </ul>
+     */
+    ModbusError initialise();
+    
+    /**
+     * @brief Start the esp-modbus communication stack and switch the UART to RS485 half duplex mode.
+     *
+     * @return An instance of ModbusError representing the result of the start process.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - Start process was successful
+     * <li> ModbusError::INVALID_ARG - Invalid argument error
+     * </ul>
+     */
+    ModbusError start() override;
+    
+    /**
+     * @brief Stop the esp-modbus communication stack.
+     *
+     * @return An instance of ModbusError representing the result of the stop process. <br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - Stop process was successful
+     * <li> ModbusError::INVALID_STATE - Invalid state error, likely indicating that the Modbus was never started
+     * </ul>
+     */
+    ModbusError stop() override;
+    
+    /**
+     * @brief Send a request using `mbc_master_send_request`.
+     *
+     * @details esp-modbus does not pass on the exception code of exception responses, they are returned as one of its
+     * generic errors instead of the corresponding exception.
+     *
+     * @param request The request to send.
+     * @param data Pointer to the request data.
+     * @return ModbusError containing the result of the request.
+     */
+    ModbusError sendRequest(const ModbusRequest& request, void* data) override;
+    
+    /**
+     * @brief Get the RAM the transport occupies, not including the memory of the esp-modbus master.
+     *
+     * @return The size of the transport in bytes.
+     */
+    size_t memoryFootprint() const override;
+    
+    /**
+     * @brief Get the context handle of the underlying esp-modbus master.
+     *
+     * @return Non owning pointer to the context handle, `nullptr` if the transport was not initialised.
+     */
+    void* getContext() const;
+
+private:
+    ModbusConfig m_config;
+    void* m_context = nullptr;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SERIALTRANSPORT_H
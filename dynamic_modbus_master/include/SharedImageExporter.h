@@ -0,0 +1,97 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SHAREDIMAGEEXPORTER_H
+#define DYNAMIC_MODBUS_MASTER_SHAREDIMAGEEXPORTER_H
+
+#include "ModbusError.h"
+#include "ProcessImage.h"
+#include "SharedImageLayout.h"
+#include <cstddef>
+#include <string>
+
+namespace dynamic_modbus_master {
+
+/**
+ * @brief Publishes a dynamic_modbus_master::ProcessImage into a POSIX shared memory segment, only available on the
+ * linux target.
+ *
+ * @details The segment has the fixed layout described in dynamic_modbus_master::SharedImageHeader. Every update of a
+ * request of the image is copied into the segment by the updating task, protected by the sequence counter of its
+ * block, so other processes read the values with dynamic_modbus_master::SharedImageReader without any round trip.
+ *
+ * @code{.cpp}
+ * ProcessImage image;
+ * image.add<float>(meter, RegisterType::INPUT, 12);
+ * SharedImageExporter exporter(image);
+ * exporter.open("/dmm_image");
+ * scheduler.addJob(std::chrono::milliseconds(100), [&] { return image.update(); });
+ * @endcode
+ */
+class SharedImageExporter {
+public:
+    /**
+     * @brief Creates an exporter for an image.
+     *
+     * @param image The image to export, must outlive the exporter.
+     */
+    explicit SharedImageExporter(ProcessImage& image);
+    
+    /**
+     * @brief Closes the segment if it is open.
+     */
+    ~SharedImageExporter();
+    
+    SharedImageExporter(const SharedImageExporter&) = delete;
+    SharedImageExporter& operator=(const SharedImageExporter&) = delete;
+    
+    /**
+     * @brief Create the segment and start publishing, fixes the layout of the image.
+     *
+     * @details An existing segment with the same name is unlinked and replaced by a new one, readers that still map it
+     * keep reading its last values until they reopen the segment. Blocks report ModbusError::INVALID_STATE until
+     * their first update after opening.
+     *
+     * @param name The name of the segment, starting with a slash, see `shm_open`.
+     * @return ModbusError::OK if the segment was created. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The exporter is already open.
+     * <li> ModbusError::FAILURE - The segment could not be created or mapped.
+     * </ul>
+     */
+    ModbusError open(const char* name);
+    
+    /**
+     * @brief Stop publishing and remove the segment, readers that mapped it keep their mapping.
+     */
+    void close();
+
+private:
+    ProcessImage& m_image;
+    std::string m_name;
+    void* m_segment = nullptr;
+    size_t m_size = 0;
+    
+    void publish(size_t block, const uint16_t* registers, ModbusError error, ProcessImage::Clock::time_point updated);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SHAREDIMAGEEXPORTER_H
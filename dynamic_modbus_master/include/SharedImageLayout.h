@@ -0,0 +1,116 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SHAREDIMAGELAYOUT_H
+#define DYNAMIC_MODBUS_MASTER_SHAREDIMAGELAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace dynamic_modbus_master {
+
+constexpr uint32_t SHARED_IMAGE_MAGIC = 0x494D4D44;  //!< "DMMI" in little-endian byte order, written last by the exporter
+constexpr uint16_t SHARED_IMAGE_VERSION = 1;         //!< Incremented on every incompatible change of the layout
+
+/**
+ * @struct SharedImageHeader
+ * @brief Header at the start of a shared memory segment exported by dynamic_modbus_master::SharedImageExporter.
+ *
+ * @details The segment consists of the header, `blockCount` dynamic_modbus_master::SharedBlock descriptors starting at
+ * `blocksOffset` and `tableSize` registers starting at `tableOffset`. All fields are in host byte order, the layout
+ * does not change while the segment exists.
+ *
+ * @param magic SHARED_IMAGE_MAGIC once the segment is completely initialised.
+ * @param version SHARED_IMAGE_VERSION of the exporter.
+ * @param headerSize The size of this header in bytes.
+ * @param blockCount The number of block descriptors.
+ * @param tableSize The number of registers in the register table.
+ * @param blocksOffset The offset of the first block descriptor from the start of the segment in bytes.
+ * @param tableOffset The offset of the register table from the start of the segment in bytes.
+ * @param segmentSize The size of the segment in bytes.
+ */
+struct SharedImageHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t blockCount;
+    uint32_t tableSize;
+    uint32_t blocksOffset;
+    uint32_t tableOffset;
+    uint64_t segmentSize;
+};
+
+/**
+ * @struct SharedBlock
+ * @brief Descriptor of a single request of the exported process image.
+ *
+ * @details `sequence` is odd while the exporter writes the block. Readers read the sequence, the registers and the
+ * error and repeat if the sequence was odd or changed in the meantime.
+ *
+ * @param sequence Sequence counter of the block, only accessed atomically.
+ * @param slaveAddress The address of the device that is read.
+ * @param type The dynamic_modbus_master::RegisterType that is read.
+ * @param regStart The first register of the request.
+ * @param regSize The number of registers of the request.
+ * @param error The dynamic_modbus_master::ModbusError of the last update, ModbusError::INVALID_STATE before the first.
+ * @param offset The index of the first register of the block in the register table.
+ * @param updatedNs The CLOCK_MONOTONIC time of the last successful update in nanoseconds, INT64_MIN if there was none.
+ */
+struct SharedBlock {
+    uint32_t sequence;
+    uint8_t slaveAddress;
+    uint8_t type;
+    uint16_t regStart;
+    uint16_t regSize;
+    uint16_t error;
+    uint32_t offset;
+    int64_t updatedNs;
+};
+
+static_assert(sizeof(SharedImageHeader) == 32, "The shared layout must not depend on the compiler");
+static_assert(sizeof(SharedBlock) == 24, "The shared layout must not depend on the compiler");
+static_assert(std::atomic_ref<uint32_t>::is_always_lock_free, "Sequence counters must be address-free");
+static_assert(std::atomic_ref<uint16_t>::is_always_lock_free, "Registers and errors must be address-free");
+static_assert(std::atomic_ref<int64_t>::is_always_lock_free, "Update times must be address-free");
+
+/**
+ * @brief Get the offset of the register table of a shared memory segment, it directly follows the block descriptors.
+ *
+ * @param blockCount The number of blocks.
+ * @return The offset of the register table in bytes.
+ */
+constexpr size_t sharedTableOffset(size_t blockCount) {
+    return sizeof(SharedImageHeader) + blockCount * sizeof(SharedBlock);
+}
+
+/**
+ * @brief Get the size of a shared memory segment.
+ *
+ * @param blockCount The number of blocks.
+ * @param tableSize The number of registers.
+ * @return The size of the segment in bytes.
+ */
+constexpr size_t sharedImageSize(size_t blockCount, size_t tableSize) {
+    return sharedTableOffset(blockCount) + tableSize * sizeof(uint16_t);
+}
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SHAREDIMAGELAYOUT_H
@@ -0,0 +1,144 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SHAREDIMAGEREADER_H
+#define DYNAMIC_MODBUS_MASTER_SHAREDIMAGEREADER_H
+
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include "SharedImageLayout.h"
+#include "WordOrder.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace dynamic_modbus_master {
+
+//! Maximum time a read waits for an update of its block to complete
+constexpr std::chrono::milliseconds SHARED_IMAGE_READ_TIMEOUT{100};
+
+/**
+ * @brief Reads the process image exported by a dynamic_modbus_master::SharedImageExporter from another process.
+ *
+ * @details The segment is mapped read-only, values are copied directly from the mapping without communicating with
+ * the exporting process. The reader only depends on the headers of this component and POSIX, so it can be built into
+ * processes that do not use ESP-IDF.
+ *
+ * @code{.cpp}
+ * SharedImageReader reader;
+ * if (reader.open("/dmm_image") == ModbusError::OK) {
+ *     slave::SlaveReturn<float> power = reader.read<float>(1, RegisterType::INPUT, 12);
+ * }
+ * @endcode
+ */
+class SharedImageReader {
+public:
+    SharedImageReader() = default;
+    
+    /**
+     * @brief Unmaps the segment if it is open.
+     */
+    ~SharedImageReader();
+    
+    SharedImageReader(const SharedImageReader&) = delete;
+    SharedImageReader& operator=(const SharedImageReader&) = delete;
+    
+    /**
+     * @brief Map an exported segment.
+     *
+     * @param name The name of the segment, as passed to SharedImageExporter::open.
+     * @return ModbusError::OK if the segment was mapped. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The reader is already open.
+     * <li> ModbusError::INVALID_RESPONSE - The segment is not initialised yet, has a different version, is truncated or
+     * its offsets are inconsistent.
+     * <li> ModbusError::FAILURE - No segment with this name exists or it could not be mapped.
+     * </ul>
+     */
+    ModbusError open(const char* name);
+    
+    /**
+     * @brief Unmap the segment.
+     */
+    void close();
+    
+    /**
+     * @brief Get the number of blocks of the image.
+     *
+     * @return The number of blocks, 0 if the reader is not open.
+     */
+    size_t blockCount() const;
+    
+    /**
+     * @brief Get the descriptor of a block, e.g. to enumerate the exported registers.
+     *
+     * @param index The index of the block, must be less than `blockCount`.
+     * @return The descriptor, its sequence, error and update time are a snapshot.
+     */
+    SharedBlock block(size_t index) const;
+    
+    /**
+     * @brief Read consecutive registers, all registers must belong to a single block.
+     *
+     * @param slaveAddress The address of the device.
+     * @param type The register type.
+     * @param reg The first register.
+     * @param size The number of registers.
+     * @param registers Receives the registers.
+     * @param updatedNs Receives the CLOCK_MONOTONIC time of the last successful update of the block, may be nullptr.
+     * @return The error of the last update of the block. ModbusError::ADDRESS_UNAVAILABLE if no block contains the registers,
+     * ModbusError::INVALID_STATE if the reader is not open, ModbusError::TIMEOUT if the block was still being updated
+     * after SHARED_IMAGE_READ_TIMEOUT, e.g. because the exporting process died during an update.
+     */
+    ModbusError readRegisters(uint8_t slaveAddress, RegisterType type, uint16_t reg, uint16_t size,
+                              uint16_t* registers, int64_t* updatedNs = nullptr) const;
+    
+    /**
+     * @brief Read a value.
+     *
+     * @tparam T The type of the value. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device transmits the value in.
+     * @param slaveAddress The address of the device.
+     * @param type The register type.
+     * @param reg The first register of the value.
+     * @return The value and the error of the last update of its block, see `readRegisters`.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB> requires (sizeof(T) % sizeof(uint16_t) == 0)
+    slave::SlaveReturn<T> read(uint8_t slaveAddress, RegisterType type, uint16_t reg) const {
+        uint16_t registers[sizeof(T) / sizeof(uint16_t)]{};
+        ModbusError error = readRegisters(slaveAddress, type, reg, sizeof(T) / sizeof(uint16_t), registers);
+        T value{};
+        convertRegisters<T, Order>(registers, &value, 1);
+        return {error, value};
+    }
+
+private:
+    const uint8_t* m_segment = nullptr;
+    size_t m_size = 0;
+    
+    const SharedImageHeader& header() const;
+    
+    const SharedBlock* blocks() const;
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SHAREDIMAGEREADER_H
@@ -0,0 +1,175 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_SIMULATEDTRANSPORT_H
+#define DYNAMIC_MODBUS_MASTER_SIMULATEDTRANSPORT_H
+
+#include "ModbusTransport.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @struct SimulatedSlave
+ * @brief Register table of a slave device that is simulated by dynamic_modbus_master::transport::SimulatedTransport.
+ *
+ * @param holdingRegisters The holding registers of the device, starting at register 0.
+ * @param inputRegisters The input registers of the device, starting at register 0.
+ * @param coils The coils of the device, starting at coil 0.
+ * @param discreteInputs The discrete inputs of the device, starting at input 0.
+ * @param responseDelay The time the device takes to respond to a request, a request with a shorter timeout fails
+ * with ModbusError::TIMEOUT once its timeout has passed.
+ */
+struct SimulatedSlave {
+    std::vector<uint16_t> holdingRegisters;
+    std::vector<uint16_t> inputRegisters;
+    std::vector<bool> coils;
+    std::vector<bool> discreteInputs;
+    std::chrono::microseconds responseDelay{0};
+};
+
+/**
+ * @struct WireStatistics
+ * @brief Traffic that would have been caused on a real RTU bus by the requests answered by a
+ * dynamic_modbus_master::transport::SimulatedTransport.
+ *
+ * @param requests The number of requests that were sent.
+ * @param bytesSent The number of bytes of all request frames, including address and CRC.
+ * @param bytesReceived The number of bytes of all response frames, including address and CRC.
+ * @param busTimeUs The time the bus would have been occupied at the configured baud rate in microseconds,
+ * including the 3.5 character inter-frame gaps. 0 if no baud rate is configured.
+ */
+struct WireStatistics {
+    uint32_t requests;
+    uint64_t bytesSent;
+    uint64_t bytesReceived;
+    uint64_t busTimeUs;
+};
+
+/**
+ * @brief Transport answering requests in-process from the register tables of simulated slaves.
+ *
+ * @details Answers the function codes 0x01 - 0x06, 0x0F, 0x10 and 0x17 in the same way a real slave device would,
+ * including the exceptions ILLEGAL_FUNCTION, ILLEGAL_DATA_ADDRESS and ILLEGAL_DATA_VALUE. Requests to addresses
+ * without a simulated slave result in a ModbusError::TIMEOUT, just as they would on a real bus.
+ *
+ * This allows to use dynamic_modbus_master::slave::SlaveDevice without any hardware, for example on the ESP-IDF
+ * `linux` target.
+ *
+ * @code{.cpp}
+ * auto transport = std::make_unique<dynamic_modbus_master::transport::SimulatedTransport>();
+ * transport->addSlave(1, 100).holdingRegisters[4] = 42;
+ * master.initialise(std::move(transport));
+ * master.start();
+ * @endcode
+ */
+class SimulatedTransport : public ModbusTransport {
+public:
+    SimulatedTransport() = default;
+    
+    ~SimulatedTransport() override = default;
+    
+    /**
+     * @brief Add a simulated slave, replacing any slave previously added with the same address.
+     *
+     * @param address The address of the slave.
+     * @param tableSize The number of holding registers, input registers, coils and discrete inputs of the slave.
+     * @return Reference to the register table of the new slave, all entries are initialised to 0.
+     */
+    SimulatedSlave& addSlave(uint8_t address, uint16_t tableSize);
+    
+    /**
+     * @brief Get the register table of a simulated slave.
+     *
+     * @warning The table is not protected against concurrent requests, only access it while no requests are sent.
+     *
+     * @param address The address of the slave.
+     * @return Non owning pointer to the register table, `nullptr` if no slave with this address exists.
+     */
+    SimulatedSlave* getSlave(uint8_t address);
+    
+    /**
+     * @brief Set the baud rate of the simulated bus.
+     *
+     * @details If a baud rate is set every request blocks for the time its request and response frames would occupy
+     * an RTU bus with 10 bits per character, including the inter-frame gaps.
+     *
+     * @param baudRate The simulated baud rate, 0 answers requests without any delay.
+     */
+    void setBaudRate(uint32_t baudRate);
+    
+    /**
+     * @brief Get the traffic caused by all requests since the last reset.
+     *
+     * @return A snapshot of the wire statistics.
+     */
+    WireStatistics getWireStatistics();
+    
+    /**
+     * @brief Reset the wire statistics to 0.
+     */
+    void resetWireStatistics();
+    
+    ModbusError start() override;
+    
+    ModbusError stop() override;
+    
+    /**
+     * @brief Answer a request from the register table of the addressed slave.
+     *
+     * @param request The request to answer.
+     * @param data Pointer to the request data.
+     * @return ModbusError::OK if the request was successful. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The transport was not started.
+     * <li> ModbusError::INVALID_ARG - `data` was a `nullptr`.
+     * <li> ModbusError::TIMEOUT - No slave with the requested address exists.
+     * <li> ModbusError::ILLEGAL_FUNCTION - The function code is not supported.
+     * <li> ModbusError::ILLEGAL_DATA_ADDRESS - The request exceeds the register table of the slave.
+     * <li> ModbusError::ILLEGAL_DATA_VALUE - The quantity of the request or the written value is invalid.
+     * </ul>
+     */
+    ModbusError sendRequest(const ModbusRequest& request, void* data) override;
+    
+    /**
+     * @brief Get the RAM the transport occupies, including the register tables of all simulated slaves.
+     *
+     * @return The size of the transport in bytes.
+     */
+    size_t memoryFootprint() const override;
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<uint8_t, SimulatedSlave> m_slaves;
+    bool m_running = false;
+    uint32_t m_baudRate = 0;
+    WireStatistics m_statistics{};
+    
+    void accountTraffic(const ModbusRequest& request, ModbusError result);
+    
+    static ModbusError handleRequest(SimulatedSlave& slave, const ModbusRequest& request, void* data);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_SIMULATEDTRANSPORT_H
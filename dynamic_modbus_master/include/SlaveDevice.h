@@ -21,10 +21,23 @@
 #ifndef DYNAMIC_MODBUS_MASTER_SLAVEDEVICE_H
 #define DYNAMIC_MODBUS_MASTER_SLAVEDEVICE_H
 #include "ModbusData.hpp"
+#include <DeviceHealth.h>
 #include <ModbusError.h>
 #include <DynamicModbusMaster.h>
-#include <esp_modbus_master.h>
+#include <ModbusRequest.h>
+#include <PackedBits.hpp>
+#include <ReadPlan.h>
+#include <RequestMetrics.h>
+#include <RequestQueue.h>
+#include <RttEstimator.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <span>
 #include <SlaveDeviceIfc.h>
+#include <WordOrder.hpp>
 
 namespace dynamic_modbus_master::slave {
 /**
@@ -46,6 +59,8 @@ public:
      */
     SlaveDevice(uint8_t address, uint8_t retries, const DynamicModbusMaster& master);
     
+    SlaveDevice(const SlaveDevice& other);
+    
     ~SlaveDevice() override = default;
     
     /**
@@ -60,20 +75,24 @@ public:
      * in a Natural Number of Holding Registers compilation will fail. See dynamic_modbus_master::ModbusData
      *
      * @tparam T The type of data to be written to the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device expects values spanning multiple registers in, see dynamic_modbus_master::WordOrder.
      * @param reg The register address to start writing to.
      * @param data The data to write to the holding registers.
      * @return A `ModbusError` object indicating the status of the write request.
      */
-    template<ModbusData T>
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
     ModbusError writeHolding(uint16_t reg, T data) const {
-        mb_param_request_t request {
-                .slave_addr = m_address,
-            .command = 0x06,
-            .reg_start = reg,
-            .reg_size = (std::is_same_v<bool, T>? 1 : sizeof(T) / 2)
+        ModbusRequest request {
+                .slaveAddress = m_address,
+            .functionCode = 0x06,
+            .regStart = reg,
+            .regSize = (std::is_same_v<bool, T>? 1 : sizeof(T) / 2)
         };
-        if (request.reg_size > 1) {
-            request.command = 0x10;
+        if (request.regSize > 1) {
+            request.functionCode = 0x10;
+        }
+        if constexpr (Order != WordOrder::CDAB && sizeof(T) % sizeof(uint16_t) == 0) {
+            convertRegisters<T, Order>(&data, &data, 1);
         }
         return sendRequest(request, &data);
     }
@@ -85,24 +104,124 @@ public:
      * The function takes the register address as a parameter and returns a `SlaveReturn` object containing the read data and any error that occurred.
      *
      * @tparam T The type of data to be read from the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device transmits values spanning multiple registers in, see dynamic_modbus_master::WordOrder.
      * @param reg The register address to start reading from.
      * @return A `SlaveReturn` object containing the read data and the status of the read request.
      */
-    template<ModbusData T>
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
     SlaveReturn<T> readHolding(uint16_t reg) const {
-        mb_param_request_t request {
-                .slave_addr = m_address,
-                .command = 0x03,
-                .reg_start = reg,
-                .reg_size = sizeof(T) / sizeof(uint16_t)
+        ModbusRequest request {
+                .slaveAddress = m_address,
+                .functionCode = 0x03,
+                .regStart = reg,
+                .regSize = sizeof(T) / sizeof(uint16_t)
         };
         
-        T data = 0;
+        T data{};
         ModbusError error = sendRequest(request, &data);
+        if constexpr (Order != WordOrder::CDAB && sizeof(T) % sizeof(uint16_t) == 0) {
+            convertRegisters<T, Order>(&data, &data, 1);
+        }
         
         return SlaveReturn{error, data};
     }
     
+    /**
+     * @brief Writes an array of values to consecutive holding registers of a Modbus slave device.
+     *
+     * @details Every element occupies `sizeof(T) / 2` registers in the same layout as `writeHolding` with a single
+     * value. Up to dynamic_modbus_master::MAX_WRITE_REGISTERS registers are sent per request, larger arrays are
+     * split into consecutive requests at element boundaries. The values are sent directly from the array.
+     *
+     * @tparam T The type of the elements. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device expects the elements in, see dynamic_modbus_master::WordOrder.
+     * @tparam Extent The extent of the span, deduced for static and dynamic extents.
+     * @param reg The register address to start writing to.
+     * @param values The values to write.
+     * @return A `ModbusError` object indicating the status of the write, the error of the first failed request, in
+     * which case the registers of all previous requests have been written. ModbusError::INVALID_ARG if the array is
+     * empty or exceeds the register address range.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB, size_t Extent = std::dynamic_extent>
+    requires (sizeof(T) % sizeof(uint16_t) == 0)
+    ModbusError writeHolding(uint16_t reg, std::span<T, Extent> values) const {
+        return writeArray(reg, values.data(), values.size(), sizeof(T) / sizeof(uint16_t), codecOf<T, Order>());
+    }
+    
+    /**
+     * @brief Reads consecutive holding registers of a Modbus slave device into an array.
+     *
+     * @details Every element occupies `sizeof(T) / 2` registers in the same layout as `readHolding` with a single
+     * value. Up to dynamic_modbus_master::MAX_READ_REGISTERS registers are read per request, larger arrays are split
+     * into consecutive requests at element boundaries. The responses are decoded directly into the array.
+     *
+     * @tparam T The type of the elements. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device transmits the elements in, see dynamic_modbus_master::WordOrder.
+     * @tparam Extent The extent of the span, deduced for static and dynamic extents.
+     * @param reg The register address to start reading from.
+     * @param values The array the values are read into, its size determines the number of registers to read.
+     * @return A `ModbusError` object indicating the status of the read, the error of the first failed request, in
+     * which case the elements of all previous requests have been read. ModbusError::INVALID_ARG if the array is
+     * empty or exceeds the register address range.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB, size_t Extent = std::dynamic_extent>
+    requires (sizeof(T) % sizeof(uint16_t) == 0 && !std::is_const_v<T>)
+    ModbusError readHolding(uint16_t reg, std::span<T, Extent> values) const {
+        return readArray(RegisterType::HOLDING, reg, values.data(), values.size(), sizeof(T) / sizeof(uint16_t),
+                         codecOf<T, Order>());
+    }
+    
+    /**
+     * @brief Writes data to holding registers and reads holding registers of a Modbus slave device in one transaction.
+     *
+     * @details Uses Function Code 0x17 (Read/Write Multiple Registers), the device performs the write before the read.
+     * Devices that answer with `ModbusError::ILLEGAL_FUNCTION`, and transports that cannot send Function Code 0x17,
+     * are served with two requests instead, `writeHolding` followed by `readHolding`. The device remembers the
+     * rejection and uses two requests for all further calls, the rejected request is neither passed to the error
+     * handler nor counted as failed request.
+     *
+     * @tparam W The type of data to be written to the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam R The type of data to be read from the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @param writeReg The register address to start writing to.
+     * @param data The data to write to the holding registers.
+     * @param readReg The register address to start reading from.
+     * @return A `SlaveReturn` object containing the read data and the status of the request, if the write failed the
+     * status of the write.
+     */
+    template<ModbusData W, ModbusData R>
+    SlaveReturn<R> writeReadHolding(uint16_t writeReg, W data, uint16_t readReg) const {
+        constexpr uint16_t writeSize = std::max<uint16_t>(1, sizeof(W) / sizeof(uint16_t));
+        constexpr uint16_t readSize = std::max<uint16_t>(1, sizeof(R) / sizeof(uint16_t));
+        static_assert(writeSize <= MAX_READ_WRITE_REGISTERS && readSize <= MAX_READ_REGISTERS,
+                      "Data does not fit into a single request");
+        ModbusRequest request {
+            .slaveAddress = m_address,
+            .functionCode = 0x17,
+            .regStart = readReg,
+            .regSize = readSize,
+            .writeStart = writeReg,
+            .writeSize = writeSize
+        };
+        
+        uint16_t buffer[writeSize + readSize]{};
+        std::memcpy(buffer, &data, std::min(sizeof(W), sizeof(uint16_t) * writeSize));
+        ModbusError error = ModbusError::SLAVE_NOT_SUPPORTED;
+        if (!m_readWriteUnsupported.load(std::memory_order_relaxed)) {
+            error = sendRequest(request, buffer, true);
+        }
+        if (error == ModbusError::ILLEGAL_FUNCTION || error == ModbusError::SLAVE_NOT_SUPPORTED) {
+            m_readWriteUnsupported.store(true, std::memory_order_relaxed);
+            error = writeHolding<W>(writeReg, data);
+            if (error != ModbusError::OK) {
+                return {error, R{}};
+            }
+            return readHolding<R>(readReg);
+        }
+        
+        R result{};
+        std::memcpy(&result, buffer + writeSize, std::min(sizeof(R), sizeof(uint16_t) * readSize));
+        return {error, result};
+    }
     
     /**
      * @brief Writes data to the coils of a Modbus slave device.
@@ -123,11 +242,11 @@ public:
     template<ModbusData T>
     ModbusError writeCoils(uint16_t reg, const T data, uint16_t coilNum) const {
         if (std::is_same_v<T, bool> && coilNum == 1) {
-            mb_param_request_t request {
-                .slave_addr = m_address,
-                .command = 0x05,
-                .reg_start = reg,
-                .reg_size = coilNum
+            ModbusRequest request {
+                .slaveAddress = m_address,
+                .functionCode = 0x05,
+                .regStart = reg,
+                .regSize = coilNum
             };
             
             uint16_t sendData = (data == true ? 0xFF00 : 0x0000);
@@ -135,11 +254,11 @@ public:
             return sendRequest(request, &sendData);
         } else if (!(std::is_same_v<T, bool>) && (coilNum > 1)){
             T sendData = data;
-            mb_param_request_t  request {
-                .slave_addr = m_address,
-                .command = 0x0F,
-                .reg_start = reg,
-                .reg_size = coilNum
+            ModbusRequest request {
+                .slaveAddress = m_address,
+                .functionCode = 0x0F,
+                .regStart = reg,
+                .regSize = coilNum
             };
             
             return sendRequest(request, &sendData);
@@ -148,6 +267,42 @@ public:
         }
     }
     
+    /**
+     * @brief Writes a range of coils of a Modbus slave device from a set of bits.
+     *
+     * @details Up to dynamic_modbus_master::MAX_WRITE_BITS coils are written per request with Function Code 0x0F, a
+     * single coil with Function Code 0x05. Larger sets are split into consecutive requests.
+     *
+     * @tparam N The number of coils to write.
+     * @param reg The first coil to write.
+     * @param coils The states of the coils, bit `i` is written to coil `reg + i`.
+     * @return A `ModbusError` object indicating the status of the write, the error of the first failed request.
+     * ModbusError::INVALID_ARG if the range exceeds the address range.
+     */
+    template<size_t N>
+    ModbusError writeCoils(uint16_t reg, const PackedBits<N>& coils) const {
+        return writeBits(reg, coils.data(), N);
+    }
+    
+    /**
+     * @brief Reads a range of coils of a Modbus slave device into a set of bits.
+     *
+     * @details Up to dynamic_modbus_master::MAX_READ_BITS coils are read per request, larger sets are split into
+     * consecutive requests. The responses are received directly into the set.
+     *
+     * @tparam N The number of coils to read.
+     * @param reg The first coil to read.
+     * @param coils Receives the states of the coils, bit `i` holds coil `reg + i`.
+     * @return A `ModbusError` object indicating the status of the read, the error of the first failed request.
+     * ModbusError::INVALID_ARG if the range exceeds the address range.
+     */
+    template<size_t N>
+    ModbusError readCoils(uint16_t reg, PackedBits<N>& coils) const {
+        ModbusError error = readBits(RegisterType::COIL, reg, coils.data(), N);
+        coils.clearPadding();
+        return error;
+    }
+    
     /**
         * @brief Reads data from the coils of a Modbus slave device.
         *
@@ -162,12 +317,12 @@ public:
         * @return A `SlaveReturn` object containing the read data and the status of the read request.
         */
     template<ModbusData T>
-    SlaveReturn<T> readCoils(uint16_t reg, uint16_t coilNum) {
-        mb_param_request_t request {
-            .slave_addr = m_address,
-            .command = 0x01,
-            .reg_start = reg,
-            .reg_size = coilNum
+    SlaveReturn<T> readCoils(uint16_t reg, uint16_t coilNum) const {
+        ModbusRequest request {
+            .slaveAddress = m_address,
+            .functionCode = 0x01,
+            .regStart = reg,
+            .regSize = coilNum
         };
         if (std::is_same_v<T, bool> && coilNum == 1) {
             uint8_t data = 0;
@@ -189,25 +344,48 @@ public:
      * The function takes the register address as a parameter and returns a `SlaveReturn` object containing the read data and any error that occurred.
      *
      * @tparam T The type of data to be read from the input registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device transmits values spanning multiple registers in, see dynamic_modbus_master::WordOrder.
      * @param reg The register address to start reading from.
      * @return A `SlaveReturn` object containing the read data and the status of the read request.
      */
-    template<ModbusData T>
-    SlaveReturn<T> readInputs(uint16_t reg) {
-        mb_param_request_t request {
-            .slave_addr = m_address,
-            .command = 0x04,
-            .reg_start = reg,
-            .reg_size = (std::is_same_v<bool, T>? 1 : sizeof(T) / 2)
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    SlaveReturn<T> readInputs(uint16_t reg) const {
+        ModbusRequest request {
+            .slaveAddress = m_address,
+            .functionCode = 0x04,
+            .regStart = reg,
+            .regSize = (std::is_same_v<bool, T>? 1 : sizeof(T) / 2)
         };
         
-        T data = 0;
+        T data{};
         ModbusError error;
         error = sendRequest(request, &data);
+        if constexpr (Order != WordOrder::CDAB && sizeof(T) % sizeof(uint16_t) == 0) {
+            convertRegisters<T, Order>(&data, &data, 1);
+        }
         
         return {error, data};
     }
     
+    /**
+     * @brief Reads consecutive input registers of a Modbus slave device into an array, see `readHolding` with an
+     * array.
+     *
+     * @tparam T The type of the elements. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+     * @tparam Order The word order the device transmits the elements in, see dynamic_modbus_master::WordOrder.
+     * @tparam Extent The extent of the span, deduced for static and dynamic extents.
+     * @param reg The register address to start reading from.
+     * @param values The array the values are read into, its size determines the number of registers to read.
+     * @return A `ModbusError` object indicating the status of the read, the error of the first failed request.
+     * ModbusError::INVALID_ARG if the array is empty or exceeds the register address range.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB, size_t Extent = std::dynamic_extent>
+    requires (sizeof(T) % sizeof(uint16_t) == 0 && !std::is_const_v<T>)
+    ModbusError readInputs(uint16_t reg, std::span<T, Extent> values) const {
+        return readArray(RegisterType::INPUT, reg, values.data(), values.size(), sizeof(T) / sizeof(uint16_t),
+                         codecOf<T, Order>());
+    }
+    
     /**
      * @brief Reads data from the discrete inputs of a Modbus slave device.
      *
@@ -216,12 +394,12 @@ public:
      * @return A `SlaveReturn` object containing the read data and the status of the read request.
      */
     template<ModbusData T>
-    SlaveReturn<T> readDiscreteInputs(uint16_t reg) {
-        mb_param_request_t request {
-                .slave_addr = m_address,
-                .command = 0x02,
-                .reg_start = reg,
-                .reg_size = (std::is_same_v<bool, T>? 1 : sizeof(T) * 8)
+    SlaveReturn<T> readDiscreteInputs(uint16_t reg) const {
+        ModbusRequest request {
+                .slaveAddress = m_address,
+                .functionCode = 0x02,
+                .regStart = reg,
+                .regSize = (std::is_same_v<bool, T>? 1 : sizeof(T) * 8)
         };
         
         if (std::is_same_v<bool, T>) {
@@ -231,7 +409,7 @@ public:
             
             return {error, (data != 0)};
         } else {
-            T data = 0;
+            T data{};
             ModbusError error;
             error = sendRequest(request, &data);
             
@@ -239,20 +417,292 @@ public:
         }
     }
     
+    /**
+     * @brief Reads a range of discrete inputs of a Modbus slave device into a set of bits, see `readCoils` with a set
+     * of bits.
+     *
+     * @tparam N The number of discrete inputs to read.
+     * @param reg The first discrete input to read.
+     * @param inputs Receives the states of the discrete inputs, bit `i` holds discrete input `reg + i`.
+     * @return A `ModbusError` object indicating the status of the read, the error of the first failed request.
+     * ModbusError::INVALID_ARG if the range exceeds the address range.
+     */
+    template<size_t N>
+    ModbusError readDiscreteInputs(uint16_t reg, PackedBits<N>& inputs) const {
+        ModbusError error = readBits(RegisterType::DISCRETE_INPUT, reg, inputs.data(), N);
+        inputs.clearPadding();
+        return error;
+    }
+    
+    /**
+     * @brief Asynchronous variant of `writeHolding`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be written to the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device expects values spanning multiple registers in.
+     * @param reg The register address to start writing to.
+     * @param data The data to write to the holding registers.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    ModbusError writeHoldingAsync(uint16_t reg, T data, RequestCallback<void(ModbusError)> callback = {},
+                                  RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, data, callback = std::move(callback)] {
+            ModbusError error = writeHolding<T, Order>(reg, data);
+            if (callback) {
+                callback(error);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `readHolding`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be read from the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device transmits values spanning multiple registers in.
+     * @param reg The register address to start reading from.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    ModbusError readHoldingAsync(uint16_t reg, RequestCallback<void(SlaveReturn<T>)> callback,
+                                 RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, callback = std::move(callback)] {
+            SlaveReturn<T> result = readHolding<T, Order>(reg);
+            if (callback) {
+                callback(result);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `writeReadHolding`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam W The type of data to be written to the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam R The type of data to be read from the holding registers. This type must meet the `ModbusData` concept requirements.
+     * @param writeReg The register address to start writing to.
+     * @param data The data to write to the holding registers.
+     * @param readReg The register address to start reading from.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData W, ModbusData R>
+    ModbusError writeReadHoldingAsync(uint16_t writeReg, W data, uint16_t readReg,
+                                      RequestCallback<void(SlaveReturn<R>)> callback,
+                                      RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, writeReg, data, readReg, callback = std::move(callback)] {
+            SlaveReturn<R> result = writeReadHolding<W, R>(writeReg, data, readReg);
+            if (callback) {
+                callback(result);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `writeCoils`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be written to the coils. This type must meet the `ModbusData` concept requirements.
+     * @param reg The register address to start writing to.
+     * @param data The data to write to the coils.
+     * @param coilNum The number of coils to write.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T>
+    ModbusError writeCoilsAsync(uint16_t reg, const T data, uint16_t coilNum,
+                                RequestCallback<void(ModbusError)> callback = {},
+                                RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, data, coilNum, callback = std::move(callback)] {
+            ModbusError error = writeCoils<T>(reg, data, coilNum);
+            if (callback) {
+                callback(error);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `readCoils`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be read from the coils. This type must meet the `ModbusData` concept requirements.
+     * @param reg The register address to start reading from.
+     * @param coilNum The number of coils to read.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T>
+    ModbusError readCoilsAsync(uint16_t reg, uint16_t coilNum, RequestCallback<void(SlaveReturn<T>)> callback,
+                               RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, coilNum, callback = std::move(callback)] {
+            SlaveReturn<T> result = readCoils<T>(reg, coilNum);
+            if (callback) {
+                callback(result);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `readInputs`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be read from the input registers. This type must meet the `ModbusData` concept requirements.
+     * @tparam Order The word order the device transmits values spanning multiple registers in.
+     * @param reg The register address to start reading from.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+    ModbusError readInputsAsync(uint16_t reg, RequestCallback<void(SlaveReturn<T>)> callback,
+                                RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, callback = std::move(callback)] {
+            SlaveReturn<T> result = readInputs<T, Order>(reg);
+            if (callback) {
+                callback(result);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Asynchronous variant of `readDiscreteInputs`, the request is executed by the bus task of the master.
+     *
+     * @warning The device must outlive all of its pending asynchronous requests.
+     *
+     * @tparam T The type of data to be read from the discrete inputs. This type must meet the `ModbusData` concept requirements.
+     * @param reg The register address to start reading from.
+     * @param callback Invoked by the bus task with the result of the request, may be empty.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, otherwise the error of RequestQueue::enqueue.
+     */
+    template<ModbusData T>
+    ModbusError readDiscreteInputsAsync(uint16_t reg, RequestCallback<void(SlaveReturn<T>)> callback,
+                                        RequestPriority priority = RequestPriority::MONITORING) const {
+        return enqueue([this, reg, callback = std::move(callback)] {
+            SlaveReturn<T> result = readDiscreteInputs<T>(reg);
+            if (callback) {
+                callback(result);
+            }
+        }, priority);
+    }
+    
+    /**
+     * @brief Reads a raw block of registers or bits from the slave device.
+     *
+     * @details Uses the function code corresponding to the register type, the data is written to the buffer in the
+     * layout described in dynamic_modbus_master::ModbusRequest.
+     *
+     * @param type The register type to read.
+     * @param reg The first register or bit to read.
+     * @param size The number of registers or bits to read.
+     * @param buffer The buffer the data is written to, must be large enough for `size` registers or bits.
+     * @return A `ModbusError` object indicating the status of the read request.
+     */
+    ModbusError readBlock(RegisterType type, uint16_t reg, uint16_t size, void* buffer) const;
+    
+    /**
+     * @brief Writes a raw block of holding registers or coils to the slave device.
+     *
+     * @details A single register or coil is written with Function Code 0x06 or 0x05, multiple with 0x10 or 0x0F. The
+     * data is read from the buffer in the layout described in dynamic_modbus_master::ModbusRequest, a single coil is
+     * taken from the least significant bit of the first byte.
+     *
+     * @param type The register type to write, RegisterType::HOLDING or RegisterType::COIL.
+     * @param reg The first register or coil to write.
+     * @param size The number of registers or coils to write.
+     * @param buffer The buffer containing the data, must contain `size` registers or bits.
+     * @return A `ModbusError` object indicating the status of the write request, ModbusError::INVALID_ARG for
+     * read-only register types.
+     */
+    ModbusError writeBlock(RegisterType type, uint16_t reg, uint16_t size, const void* buffer) const;
+    
+    /**
+     * @brief Reads all points of a read plan with the minimum number of requests.
+     *
+     * @details Sends one request per block of the plan, see dynamic_modbus_master::slave::ReadPlan, and distributes
+     * the responses to the `SlaveReturn` of every point, including the error of the request that served the point.
+     *
+     * @param plan The plan to execute.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError read(ReadPlan& plan) const;
+    
+    /**
+     * @brief Get the round-trip time estimate of the device, which determines its response timeout.
+     *
+     * @return The estimator of the device.
+     */
+    const RttEstimator& getRttEstimator() const;
+    
+    /**
+     * @brief Get the latency histograms, retry, error and traffic counters of the requests of this device.
+     *
+     * @details The requests are additionally counted by the metrics of the master, see
+     * DynamicModbusMaster::getMetrics.
+     *
+     * @return The metrics of the device, use RequestMetrics::snapshot to read them.
+     */
+    RequestMetrics& getMetrics() const;
+    
+    /**
+     * @brief Get the health of the device, which decides whether its requests are sent, see
+     * dynamic_modbus_master::slave::DeviceHealth.
+     *
+     * @return The health of the device.
+     */
+    DeviceHealth& getHealth() const;
+    
+    /**
+     * @brief Get the address of the device on its bus.
+     *
+     * @return The slave address.
+     */
+    uint8_t getAddress() const;
+    
 private:
     uint8_t m_address;
     uint8_t m_retries;
     const DynamicModbusMaster& m_master;
+    mutable RttEstimator m_rtt;
+    mutable RequestMetrics m_metrics;
+    mutable DeviceHealth m_health;
+    mutable std::atomic<bool> m_readWriteUnsupported{false};    // Function Code 0x17 was rejected
+    
+    /**
+     * @brief Converts `count` elements between registers as received and values, see dynamic_modbus_master::convertRegisters.
+     */
+    using RegisterCodec = void (*)(const void* source, void* destination, size_t count);
     
     /**
      * @brief Helper function to send a modbus request
      *
      * @brief This function handles all requests in a consistent manner and if a timeout occurs, re-attempts the request
-     * for the specified amount of time.
+     * for the specified amount of time. Requests are sent through the transport of the master this device belongs to.
+     *
+     * @details Unless the request specifies a timeout, every attempt waits for the timeout derived from the measured
+     * round-trip time of the device, see dynamic_modbus_master::slave::RttEstimator. Retries are spaced by a
+     * randomised, exponentially growing delay. Requests to a quarantined device fail without being sent, unless they
+     * are admitted as probe, requests to suspect devices are not retried.
      *
      * @param request Struct containing the request
      * @param data void* pointing at the target data, in case of reading requests, the data will be written to here,
      * in case of writing requests, the data will be read from here.
+     * @param probe Whether the request probes if the device supports its function code, in which case
+     * ModbusError::ILLEGAL_FUNCTION and ModbusError::SLAVE_NOT_SUPPORTED are expected and not recorded as failed request.
      * @return ModbusError containing either the error. <br>
      * Possible Error Codes:
      * <ul>
@@ -261,10 +711,101 @@ private:
      * <li> ModbusError::INVALID_ARG - Indicating an Argument was invalid.
      * <li> ModbusError::INVALID_RESPONSE - Indicating that the receiving device returned an invalid response.
      * <li> ModbusError::SLAVE_NOT_SUPPORTED - Indicating that the receiving device doesn't support the command specified in the request.
+     * <li> ModbusError::INVALID_STATE - Indicating that the master was not initialised.
+     * <li> ModbusError::DEVICE_QUARANTINED - Indicating that the device is quarantined and the request was not sent.
      * <li> ModbusError::FAILURE_OR_EXCEPTION - Indicating that a generic failure or exception occurred.
      * </ul>
      */
-    ModbusError sendRequest(mb_param_request_t request, void* data) const;
+    ModbusError sendRequest(const ModbusRequest& request, void* data, bool probe = false) const;
+    
+    /**
+     * @brief Helper function to count the result of a request in the metrics of the device and of the master, and to
+     * pass failed requests to the error handler of the master.
+     *
+     * @param request The request.
+     * @param error The result of the request.
+     * @param attempts The number of attempts of the request.
+     * @param start The time the request was started at.
+     */
+    void recordRequest(const ModbusRequest& request, ModbusError error, uint8_t attempts,
+                       std::chrono::steady_clock::time_point start) const;
+    
+    /**
+     * @brief Helper function to read an array of elements with as few requests as possible.
+     *
+     * @param type The register type to read.
+     * @param reg The first register.
+     * @param data The first element.
+     * @param count The number of elements.
+     * @param elementSize The number of registers per element.
+     * @param codec Converts the elements of every response in place, nullptr to keep the registers as received.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError readArray(RegisterType type, uint16_t reg, void* data, size_t count, size_t elementSize,
+                          RegisterCodec codec) const;
+    
+    /**
+     * @brief Helper function to write an array of elements to holding registers with as few requests as possible.
+     *
+     * @param reg The first register.
+     * @param data The first element.
+     * @param count The number of elements.
+     * @param elementSize The number of registers per element.
+     * @param codec Converts the elements of every request into a buffer before sending, nullptr to send the elements
+     * as they are.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError writeArray(uint16_t reg, const void* data, size_t count, size_t elementSize,
+                           RegisterCodec codec) const;
+    
+    /**
+     * @brief Helper function to read a range of coils or discrete inputs with as few requests as possible.
+     *
+     * @param type The register type to read, RegisterType::COIL or RegisterType::DISCRETE_INPUT.
+     * @param reg The first bit.
+     * @param data The packed bits, `(count + 7) / 8` bytes.
+     * @param count The number of bits.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError readBits(RegisterType type, uint16_t reg, uint8_t* data, size_t count) const;
+    
+    /**
+     * @brief Helper function to write a range of coils with as few requests as possible.
+     *
+     * @param reg The first coil.
+     * @param data The packed bits, `(count + 7) / 8` bytes.
+     * @param count The number of coils.
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     */
+    ModbusError writeBits(uint16_t reg, const uint8_t* data, size_t count) const;
+    
+    /**
+     * @brief Helper function to select the conversion of array elements for a word order.
+     *
+     * @tparam T The type of the elements.
+     * @tparam Order The word order of the device.
+     * @return The conversion, nullptr for WordOrder::CDAB which matches the registers as received.
+     */
+    template<ModbusData T, WordOrder Order>
+    static constexpr RegisterCodec codecOf() {
+        if constexpr (Order == WordOrder::CDAB) {
+            return nullptr;
+        } else {
+            static_assert(sizeof(T) / sizeof(uint16_t) <= MAX_WRITE_REGISTERS,
+                          "Elements converted to a word order must fit into a single request");
+            return &convertRegisters<std::remove_cv_t<T>, Order>;
+        }
+    }
+    
+    /**
+     * @brief Helper function to queue an asynchronous request with the request queue of the master.
+     *
+     * @param request The request to queue.
+     * @param priority The priority class of the request.
+     * @return ModbusError::OK if the request was queued, ModbusError::INVALID_STATE if the request queue of the
+     * master is not running, otherwise the error of RequestQueue::enqueue.
+     */
+    ModbusError enqueue(AsyncRequest request, RequestPriority priority) const;
 };
 }
 #endif //DYNAMIC_MODBUS_MASTER_SLAVEDEVICE_H
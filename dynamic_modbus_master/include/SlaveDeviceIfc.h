@@ -24,6 +24,7 @@
 #include "dmm_common.h"
 #include "ModbusData.hpp"
 #include "ModbusError.h"
+#include "WordOrder.hpp"
 
 namespace dynamic_modbus_master::slave {
 
@@ -58,11 +59,12 @@ public:
      * @param reg The register address to write the data to
      * @param data The data to be written to the register
      * @tparam D The type of data to be written
+     * @tparam Order The word order the device expects values spanning multiple registers in
      * @return A ModbusError value indicating the success or failure of the write operation
      */
-    template<ModbusData D>
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
     ModbusError writeHolding(uint16_t reg, const D& data) const {
-        return static_cast<T const*>(this)->template writeHolding<D>(reg, data);
+        return static_cast<T const*>(this)->template writeHolding<D, Order>(reg, data);
     }
     
     /**
@@ -74,11 +76,30 @@ public:
      *
      * @param reg The register address to read the data from
      * @tparam D The type of data to be read
+     * @tparam Order The word order the device transmits values spanning multiple registers in
      * @return A SlaveReturn structure containing the read data and any errors encountered during the read operation
      */
-    template<ModbusData D>
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
     SlaveReturn<D> readHolding(uint16_t reg) const {
-        return static_cast<T const*>(this)->template readHolding<D>(reg);
+        return static_cast<T const*>(this)->template readHolding<D, Order>(reg);
+    }
+    
+    /**
+     * @brief Write data to holding registers and read holding registers afterwards
+     *
+     * @details This method writes the provided data to the holding registers at the write address and then reads
+     * data from the holding registers at the read address, ideally within a single transaction.
+     *
+     * @param writeReg The register address to write the data to
+     * @param data The data to be written to the registers
+     * @param readReg The register address to read the data from
+     * @tparam W The type of data to be written, must fulfill the ModbusData concept
+     * @tparam R The type of data to be read, must fulfill the ModbusData concept
+     * @return A SlaveReturn structure containing the read data and any errors encountered during the operation
+     */
+    template<ModbusData W, ModbusData R>
+    SlaveReturn<R> writeReadHolding(uint16_t writeReg, const W& data, uint16_t readReg) const {
+        return static_cast<T const*>(this)->template writeReadHolding<W, R>(writeReg, data, readReg);
     }
     
     /**
@@ -120,11 +141,12 @@ public:
     *
     * @param reg The register address to read the data from
     * @tparam D The type of data to be read from input registers, must fulfill the ModbusData concept
+    * @tparam Order The word order the device transmits values spanning multiple registers in
     * @return A SlaveReturn structure containing the read data and any errors encountered during the read operation
     */
-    template<ModbusData D>
+    template<ModbusData D, WordOrder Order = WordOrder::CDAB>
     SlaveReturn<D> readInputs(uint16_t reg) {
-        return static_cast<T const *>(this)->template readInputs<D>(reg);
+        return static_cast<T const *>(this)->template readInputs<D, Order>(reg);
     }
     
     /**
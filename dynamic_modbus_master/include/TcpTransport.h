@@ -0,0 +1,204 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_TCPTRANSPORT_H
+#define DYNAMIC_MODBUS_MASTER_TCPTRANSPORT_H
+
+#include "ModbusPdu.h"
+#include "ModbusTransport.h"
+#include "RequestQueue.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dynamic_modbus_master::transport {
+
+/**
+ * @brief Transport sending requests to a Modbus TCP server or gateway.
+ *
+ * @details Requests are not sent in strict request/response order. Up to `maxTransactions` requests may be
+ * outstanding on the connection at the same time, responses are matched to their requests by the transaction
+ * identifier of the MBAP header. Concurrent calls of `sendRequest` from different tasks, as well as requests started
+ * via `submit`, are therefore pipelined and the throughput is limited by the server rather than by the round-trip time.
+ *
+ * The slave address of a request is sent as the unit identifier. Responses are received by a dedicated task, which also
+ * completes requests that were not answered in time with ModbusError::TIMEOUT. If the connection is lost all
+ * outstanding requests fail and the connection is reestablished with the next request.
+ *
+ * @code{.cpp}
+ * master.initialise(std::make_unique<dynamic_modbus_master::transport::TcpTransport>("192.168.1.10"));
+ * master.start();
+ * @endcode
+ */
+class TcpTransport : public ModbusTransport {
+public:
+    /**
+     * @brief Completion handler of a request started via `submit`, called with the result of the request.
+     */
+    using Completion = RequestCallback<void(ModbusError)>;
+    
+    /**
+     * @brief Creates a transport for a Modbus TCP server, the connection is established by `start`.
+     *
+     * @param host The host name or IPv4 address of the server.
+     * @param port The TCP port of the server.
+     * @param timeout The time a request may take until it is completed with ModbusError::TIMEOUT, unless the request
+     * specifies its own timeout.
+     * @param maxTransactions The maximum number of requests outstanding at the same time.
+     */
+    explicit TcpTransport(std::string host, uint16_t port = 502,
+                          std::chrono::milliseconds timeout = std::chrono::milliseconds(CONFIG_DMM_TCP_TIMEOUT_MS),
+                          size_t maxTransactions = CONFIG_DMM_TCP_MAX_TRANSACTIONS);
+    
+    /**
+     * @brief Stops the transport if it is running.
+     */
+    ~TcpTransport() override;
+    
+    /**
+     * @brief Connect to the server and start the receive task.
+     *
+     * @return An instance of ModbusError representing the result of the start process.<br>
+     * Possible Results:
+     * <ul>
+     * <li> ModbusError::OK - Start process was successful
+     * <li> ModbusError::INVALID_STATE - The transport is already running
+     * <li> ModbusError::ADDRESS_UNAVAILABLE - The host could not be resolved or the connection was refused
+     * <li> ModbusError::FAILURE - The receive task could not be created
+     * </ul>
+     */
+    ModbusError start() override;
+    
+    /**
+     * @brief Stop the receive task and close the connection, outstanding requests fail with ModbusError::INVALID_STATE.
+     *
+     * @return ModbusError::OK if the transport was stopped, ModbusError::INVALID_STATE if it was not running.
+     */
+    ModbusError stop() override;
+    
+    /**
+     * @brief Send a request and wait for its response, may be called from several tasks concurrently.
+     *
+     * @param request The request to send.
+     * @param data Pointer to the request data.
+     * @return ModbusError::OK if the request was successful. <br>
+     * Possible Error Codes:
+     * <ul>
+     * <li> ModbusError::INVALID_STATE - The transport was not started or was stopped before the response arrived.
+     * <li> ModbusError::INVALID_ARG - `data` was a `nullptr` or the request can not be encoded.
+     * <li> ModbusError::TIMEOUT - No response was received in time, including the time waiting for a free transaction.
+     * <li> ModbusError::ADDRESS_UNAVAILABLE - The connection was lost and could not be reestablished.
+     * <li> ModbusError::FAILURE - The connection was lost while the request was outstanding.
+     * <li> ModbusError::INVALID_RESPONSE - The response did not match the request.
+     * <li> Any exception the server answered with.
+     * </ul>
+     */
+    ModbusError sendRequest(const ModbusRequest& request, void* data) override;
+    
+    /**
+     * @brief Send a request without waiting for its response.
+     *
+     * @details The response data of reading requests is written to `data` before `done` is called, `data` must remain
+     * valid until then. `done` is called from the receive task, it must not block and must not call `stop`.
+     *
+     * @param request The request to send.
+     * @param data Pointer to the request data.
+     * @param done Called with the result of the request, only if the request was sent. May be empty.
+     * @return ModbusError::OK if the request was sent, ModbusError::QUEUE_FULL if `maxTransactions` requests are
+     * already outstanding, otherwise the same errors as `sendRequest` that occur before the request is sent.
+     */
+    ModbusError submit(const ModbusRequest& request, void* data, Completion done);
+    
+    /**
+     * @brief Get the number of requests currently awaiting their response.
+     *
+     * @return The number of outstanding requests.
+     */
+    size_t outstanding() const;
+    
+    /**
+     * @brief Get the RAM the transport occupies, including its transactions and the stack of the receive task.
+     *
+     * @return The size of the transport in bytes.
+     */
+    size_t memoryFootprint() const override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Transaction {
+        bool active;
+        uint16_t id;
+        ModbusRequest request;
+        void* data;
+        Clock::time_point deadline;
+        Completion done;
+        bool failed;    // Marked for completion with an error by completeFailed
+    };
+    
+    static constexpr size_t MBAP_HEADER_SIZE = 7;
+    static constexpr size_t MAX_ADU_SIZE = MBAP_HEADER_SIZE + MAX_PDU_SIZE;
+    
+    std::string m_host;
+    uint16_t m_port;
+    Clock::duration m_timeout;
+    
+    mutable std::mutex m_mutex;
+    std::vector<Transaction> m_transactions;
+    SemaphoreHandle_t m_freeTransactions;
+    uint16_t m_nextTransactionId = 0;
+    std::atomic<int> m_socket = -1;
+    
+    std::atomic<bool> m_running = false;
+    SemaphoreHandle_t m_stopped = nullptr;
+    // Only accessed by the receive task
+    std::array<uint8_t, 2 * MAX_ADU_SIZE> m_receiveBuffer{};
+    size_t m_received = 0;
+    
+    ModbusError transmit(const ModbusRequest& request, void* data, Completion done, TickType_t wait);
+    
+    ModbusError connect();
+    
+    void disconnect(ModbusError error);
+    
+    void receive();
+    
+    void handleResponse(const uint8_t* frame, size_t size);
+    
+    void expireTransactions();
+    
+    void completeFailed(ModbusError error);
+    
+    Completion release(Transaction& transaction);
+    
+    Clock::duration timeoutOf(const ModbusRequest& request) const;
+    
+    static void task(void* transport);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_TCPTRANSPORT_H
@@ -0,0 +1,220 @@
+// Copyright (c) 2024 Dominik M. Glogowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_WORDORDER_HPP
+#define DYNAMIC_MODBUS_MASTER_WORDORDER_HPP
+
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "ModbusData.hpp"
+
+namespace dynamic_modbus_master {
+
+/**
+ * @brief Order in which the bytes of values spanning multiple registers are transmitted by a device.
+ *
+ * @details The letters name the bytes of the value from the most significant (A) to the least significant byte, in
+ * the order in which they appear on the wire. For a 32-Bit value the first register contains the first two letters.
+ *
+ * Without conversion dynamic_modbus_master::slave::SlaveDevice returns the registers in the order they were received
+ * with each register in host byte order, on the little-endian ESP32 this corresponds to WordOrder::CDAB.
+ */
+enum class WordOrder : uint8_t {
+    ABCD,   //!< Big-Endian, the most significant register is transmitted first, as defined by the Modbus specification
+    CDAB,   //!< The least significant register is transmitted first, the bytes of each register are big-endian
+    BADC,   //!< The most significant register is transmitted first, the bytes of each register are swapped
+    DCBA,   //!< Little-Endian, the least significant register is transmitted first and the bytes of each register are swapped
+};
+
+/**
+ * @brief Swap the two bytes of a register.
+ *
+ * @param value The register to swap.
+ * @return The register with swapped bytes.
+ */
+constexpr uint16_t swapBytes(uint16_t value) {
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+/**
+ * @brief Decode a value from registers as received from the device.
+ *
+ * @tparam T The type of the value. This type must meet the `ModbusData` concept requirements.
+ * @tparam Order The word order the device transmits the value in.
+ * @param registers Pointer to `sizeof(T) / 2` registers in the order they were received, each in host byte order.
+ * @return The decoded value.
+ */
+template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+T decodeRegisters(const uint16_t* registers) {
+    constexpr size_t count = sizeof(T) / sizeof(uint16_t);
+    constexpr bool reverse = (Order == WordOrder::ABCD || Order == WordOrder::BADC);
+    constexpr bool swap = (Order == WordOrder::BADC || Order == WordOrder::DCBA);
+    
+    uint16_t words[count];
+    for (size_t i = 0; i < count; i++) {
+        uint16_t word = registers[reverse ? count - 1 - i : i];
+        words[i] = (swap ? swapBytes(word) : word);
+    }
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Encode a value into registers in the order they are to be transmitted to the device.
+ *
+ * @tparam T The type of the value. This type must meet the `ModbusData` concept requirements.
+ * @tparam Order The word order the device expects the value in.
+ * @param value The value to encode.
+ * @param registers Pointer to `sizeof(T) / 2` registers the value is written to, each in host byte order.
+ */
+template<ModbusData T, WordOrder Order = WordOrder::CDAB>
+void encodeRegisters(const T& value, uint16_t* registers) {
+    constexpr size_t count = sizeof(T) / sizeof(uint16_t);
+    constexpr bool reverse = (Order == WordOrder::ABCD || Order == WordOrder::BADC);
+    constexpr bool swap = (Order == WordOrder::BADC || Order == WordOrder::DCBA);
+    
+    uint16_t words[count];
+    std::memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < count; i++) {
+        uint16_t word = (swap ? swapBytes(words[i]) : words[i]);
+        registers[reverse ? count - 1 - i : i] = word;
+    }
+}
+
+/**
+ * @brief Convert a value whose registers are packed into an unsigned integer in host order between the order
+ * received from a device and the order of the host.
+ *
+ * @details Only valid on little-endian hosts, where the first register occupies the least significant bits. Every
+ * conversion is its own inverse, so the same function encodes and decodes. Reversing registers and bytes is a single
+ * byte swap, reversing only the registers or only the bytes of each register uses rotations and masked shifts, which
+ * compilers vectorise when applied to arrays.
+ *
+ * @tparam Order The word order of the device.
+ * @tparam U The unsigned integer holding 1, 2 or 4 registers.
+ * @param value The registers.
+ * @return The converted registers.
+ */
+template<WordOrder Order, typename U>
+constexpr U reorderRegisters(U value) {
+    static_assert(std::is_same_v<U, uint16_t> || std::is_same_v<U, uint32_t> || std::is_same_v<U, uint64_t>);
+    constexpr bool reverse = (Order == WordOrder::ABCD || Order == WordOrder::BADC);
+    constexpr bool swap = (Order == WordOrder::BADC || Order == WordOrder::DCBA);
+    
+    if constexpr (reverse && swap) {
+        if constexpr (std::is_same_v<U, uint16_t>) {
+            return swapBytes(value);
+        } else if constexpr (std::is_same_v<U, uint32_t>) {
+            return __builtin_bswap32(value);
+        } else {
+            return __builtin_bswap64(value);
+        }
+    }
+    if constexpr (reverse && std::is_same_v<U, uint32_t>) {
+        value = std::rotl(value, 16);
+    } else if constexpr (reverse && std::is_same_v<U, uint64_t>) {
+        constexpr uint64_t lowRegisters = 0x0000FFFF0000FFFFull;
+        value = std::rotl(value, 32);
+        value = ((value & lowRegisters) << 16) | ((value >> 16) & lowRegisters);
+    }
+    if constexpr (swap) {
+        constexpr U lowBytes = static_cast<U>(0x00FF00FF00FF00FFull);
+        value = static_cast<U>(((value & lowBytes) << 8) | ((value >> 8) & lowBytes));
+    }
+    return value;
+}
+
+/**
+ * @brief Convert an array of values between registers in the order received from a device and values of the host.
+ *
+ * @details Conversion is its own inverse, so the same function decodes received registers and encodes values to be
+ * sent. 16, 32 and 64-Bit types are converted with byte swap instructions on little-endian hosts, the loop is free of
+ * branches so compilers vectorise it on targets with SIMD shuffles. Other types fall back to `decodeRegisters`.
+ * WordOrder::CDAB does not require any conversion.
+ *
+ * @tparam T The type of the values. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+ * @tparam Order The word order of the device.
+ * @param source `count` values or `count * sizeof(T) / 2` registers to convert.
+ * @param destination Memory receiving the converted values or registers, may be the same as `source` to convert
+ * in place but must not overlap otherwise.
+ * @param count The number of values.
+ */
+template<ModbusData T, WordOrder Order> requires (sizeof(T) % sizeof(uint16_t) == 0)
+void convertRegisters(const void* source, void* destination, size_t count) {
+    constexpr size_t size = sizeof(T);
+    const auto* in = static_cast<const uint8_t*>(source);
+    auto* out = static_cast<uint8_t*>(destination);
+    
+    if constexpr (Order == WordOrder::CDAB) {
+        if (in != out) {
+            std::memcpy(out, in, size * count);
+        }
+    } else if constexpr (std::endian::native == std::endian::little && (size == 2 || size == 4 || size == 8)) {
+        using Packed = std::conditional_t<size == 2, uint16_t, std::conditional_t<size == 4, uint32_t, uint64_t>>;
+        for (size_t i = 0; i < count; i++) {
+            Packed packed;
+            std::memcpy(&packed, in + i * size, size);
+            packed = reorderRegisters<Order>(packed);
+            std::memcpy(out + i * size, &packed, size);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            uint16_t registers[size / sizeof(uint16_t)];
+            std::memcpy(registers, in + i * size, size);
+            T value = decodeRegisters<T, Order>(registers);
+            std::memcpy(out + i * size, &value, size);
+        }
+    }
+}
+
+/**
+ * @brief Decode an array of values from registers as received from the device.
+ *
+ * @tparam T The type of the values. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+ * @tparam Order The word order the device transmits the values in.
+ * @param registers Pointer to `count * sizeof(T) / 2` registers in the order they were received, each in host byte order.
+ * @param values Pointer to `count` values receiving the result.
+ * @param count The number of values.
+ */
+template<ModbusData T, WordOrder Order = WordOrder::CDAB> requires (sizeof(T) % sizeof(uint16_t) == 0)
+void decodeRegisterArray(const uint16_t* registers, T* values, size_t count) {
+    convertRegisters<T, Order>(registers, values, count);
+}
+
+/**
+ * @brief Encode an array of values into registers in the order they are to be transmitted to the device.
+ *
+ * @tparam T The type of the values. This type must meet the `ModbusData` concept requirements and occupy whole registers.
+ * @tparam Order The word order the device expects the values in.
+ * @param values Pointer to `count` values to encode.
+ * @param registers Pointer to `count * sizeof(T) / 2` registers the values are written to, each in host byte order.
+ * @param count The number of values.
+ */
+template<ModbusData T, WordOrder Order = WordOrder::CDAB> requires (sizeof(T) % sizeof(uint16_t) == 0)
+void encodeRegisterArray(const T* values, uint16_t* registers, size_t count) {
+    convertRegisters<T, Order>(values, registers, count);
+}
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_WORDORDER_HPP
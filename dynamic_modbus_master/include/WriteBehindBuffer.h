@@ -0,0 +1,197 @@
+//Copyright (c) 2024 Dominik M. Glogowski
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef DYNAMIC_MODBUS_MASTER_WRITEBEHINDBUFFER_H
+#define DYNAMIC_MODBUS_MASTER_WRITEBEHINDBUFFER_H
+
+#include "ModbusData.hpp"
+#include "ModbusError.h"
+#include "ModbusRequest.h"
+#include "SlaveDevice.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace dynamic_modbus_master::slave {
+
+/**
+ * @struct WriteStatistics
+ * @brief Effectiveness of a dynamic_modbus_master::slave::WriteBehindBuffer.
+ *
+ * @param writes The number of registers and coils that were written to the buffer.
+ * @param deduplicated The number of registers and coils that were dropped, since their value was already confirmed.
+ * @param frames The number of requests that were sent to flush the buffer.
+ * @param failures The number of requests that failed, their registers and coils remain pending.
+ */
+struct WriteStatistics {
+    uint32_t writes;
+    uint32_t deduplicated;
+    uint32_t frames;
+    uint32_t failures;
+};
+
+/**
+ * @brief Write-behind buffer collecting the holding register and coil writes to a single slave device.
+ *
+ * @details Writes are not sent immediately. Instead the buffer keeps the most recent value of every written register
+ * and coil until it is flushed, either explicitly via `flush` or by `poll` once the oldest pending write has reached
+ * the maximum delay. A write of the value that was last confirmed by the device is dropped. On flush, adjacent
+ * registers are merged into a single request with Function Code 0x10 and adjacent coils into a single request with
+ * Function Code 0x0F.
+ *
+ * `poll` is typically called periodically, for example as a job of a dynamic_modbus_master::ScanScheduler.
+ *
+ * @code{.cpp}
+ * WriteBehindBuffer buffer(device, std::chrono::milliseconds(50));
+ * scheduler.addJob(std::chrono::milliseconds(10), [&] { return buffer.poll(); });
+ *
+ * buffer.writeHolding<uint16_t>(10, setpoint);
+ * buffer.writeHolding<float>(11, limit);   // Sent together with register 10 in a single request
+ * @endcode
+ *
+ * @note Only values written through the buffer are known to it, values changed by other means are not deduplicated
+ * against. Writes to the buffer wait while it is being flushed.
+ */
+class WriteBehindBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Creates an empty buffer for a device.
+     *
+     * @param device The device the writes are sent to, must outlive the buffer.
+     * @param maxDelay The maximum time a write may be pending before `poll` flushes the buffer.
+     */
+    WriteBehindBuffer(const SlaveDevice& device, std::chrono::milliseconds maxDelay);
+    
+    /**
+     * @brief Buffer a write to holding registers, see SlaveDevice::writeHolding.
+     *
+     * @tparam T The type of the data, must fulfill the ModbusData concept.
+     * @param reg The first register to write.
+     * @param data The data to write.
+     * @return ModbusError::OK, the write is sent by the next flush.
+     */
+    template<ModbusData T>
+    ModbusError writeHolding(uint16_t reg, T data) {
+        constexpr uint16_t count = std::max<uint16_t>(1, sizeof(T) / sizeof(uint16_t));
+        uint16_t values[count]{};
+        std::memcpy(values, &data, std::min(sizeof(T), sizeof(values)));
+        stage(RegisterType::HOLDING, reg, count, values);
+        return ModbusError::OK;
+    }
+    
+    /**
+     * @brief Buffer a write to coils, see SlaveDevice::writeCoils.
+     *
+     * @tparam T The type of the data, must fulfill the ModbusData concept.
+     * @param reg The first coil to write.
+     * @param data The data to write, the bits are written to the coils starting with the least significant bit.
+     * @param coilNum The number of coils to write, 1 if T is `bool`, otherwise more than 1.
+     * @return ModbusError::OK if the write was buffered, ModbusError::INVALID_ARG if `coilNum` does not match T.
+     */
+    template<ModbusData T>
+    ModbusError writeCoils(uint16_t reg, T data, uint16_t coilNum) {
+        constexpr bool single = std::is_same_v<T, bool>;
+        constexpr uint16_t capacity = (single ? 1 : sizeof(T) * 8);
+        if ((single && coilNum != 1) || (!single && (coilNum < 2 || coilNum > capacity))) {
+            return ModbusError::INVALID_ARG;
+        }
+        uint16_t values[capacity]{};
+        if constexpr (single) {
+            values[0] = data;
+        } else {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(&data);
+            for (uint16_t i = 0; i < coilNum; i++) {
+                values[i] = (bytes[i / 8] >> (i % 8)) & 1;
+            }
+        }
+        stage(RegisterType::COIL, reg, coilNum, values);
+        return ModbusError::OK;
+    }
+    
+    /**
+     * @brief Send all pending writes.
+     *
+     * @return ModbusError::OK if all requests were successful, otherwise the error of the first failed request.
+     * Registers and coils of failed requests remain pending and are sent again by the next flush.
+     */
+    ModbusError flush();
+    
+    /**
+     * @brief Flush the buffer if the oldest pending write has reached the maximum delay.
+     *
+     * @param now The current time.
+     * @return ModbusError::OK if the buffer was not due or was flushed successfully, otherwise the result of `flush`.
+     */
+    ModbusError poll(Clock::time_point now = Clock::now());
+    
+    /**
+     * @brief Get the time at which `poll` flushes the buffer.
+     *
+     * @return The deadline of the oldest pending write, `Clock::time_point::max()` if no write is pending.
+     */
+    Clock::time_point deadline() const;
+    
+    /**
+     * @brief Get the number of registers and coils waiting to be sent.
+     *
+     * @return The number of pending registers and coils.
+     */
+    size_t pending() const;
+    
+    /**
+     * @brief Get the counters of the buffer.
+     *
+     * @return A snapshot of the counters.
+     */
+    WriteStatistics getStatistics() const;
+
+private:
+    struct Value {
+        uint16_t reg;
+        uint16_t value;
+    };
+    
+    struct Table {
+        RegisterType type;
+        // Both sorted by register
+        std::vector<Value> pending;
+        std::vector<Value> confirmed;
+    };
+    
+    const SlaveDevice& m_device;
+    Clock::duration m_maxDelay;
+    mutable std::mutex m_mutex;
+    Table m_holding{RegisterType::HOLDING, {}, {}};
+    Table m_coils{RegisterType::COIL, {}, {}};
+    Clock::time_point m_deadline = Clock::time_point::max();
+    WriteStatistics m_statistics{};
+    
+    void stage(RegisterType type, uint16_t reg, uint16_t count, const uint16_t* values);
+    
+    ModbusError flush(Table& table);
+};
+}
+
+#endif //DYNAMIC_MODBUS_MASTER_WRITEBEHINDBUFFER_H